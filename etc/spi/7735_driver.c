@@ -7,19 +7,111 @@
 #include <linux/gpio/consumer.h>
 #include <linux/fb.h>
 #include <linux/vmalloc.h>
+#include <linux/slab.h>
+#include <linux/bitmap.h>
+#include <linux/completion.h>
+#include <linux/list.h>
+#include <linux/spinlock.h>
+#include <linux/mutex.h>
+#include <linux/uaccess.h>
+#include <linux/workqueue.h>
+#include <linux/jiffies.h>
+#include <linux/math64.h>
+#include <linux/sysfs.h>
 #include <linux/string.h>
+#include <linux/ktime.h>
 #include <asm/pgtable.h> // remap_pfn_range 용
 #include <asm/io.h>
 #include <linux/mm.h>    // vmalloc_to_pfn 용
 
+#include "st7735.h"
+#include "st7735_pixel.h"
+#include "jmw_stats.h" // sensor_system/drivers (Makefile의 -I)
+
+// 7735_neon.c를 같이 빌드하는 경우 (Makefile과 같은 조건)
+#if defined(CONFIG_ARM64) && defined(CONFIG_KERNEL_MODE_NEON)
+#define ST7735_NEON
+#include <asm/neon.h>
+#include <asm/simd.h>
+#endif
+
 #define LCD_WIDTH 128
 #define LCD_HEIGHT 160
 #define X_OFFSET 2
 #define Y_OFFSET 1
 
+#define ST7735_CHUNK_SIZE 4096 // 픽셀 데이터 한번 전송 크기 (전체 폭 16줄)
+#define ST7735_NR_CHUNKS 4     // 변환 <-> 전송 겹치기용 chunk 버퍼 수
+#define ST7735_WIN_PARAM 11    // CASET(1+4) RASET(1+4) RAMWR(1)
+
+/* SPI 클럭 autotune: 화면 왼쪽 위 32x8 영역에 패턴 쓰고 RAMRD로 확인 */
+#define ST7735_TUNE_W 32
+#define ST7735_TUNE_H 8
+#define ST7735_TUNE_PIXELS (ST7735_TUNE_W * ST7735_TUNE_H)
+#define ST7735_TUNE_RDLEN (ST7735_TUNE_PIXELS * 3 + 1) // 더미 + 픽셀당 최대 3바이트 (18비트 읽기)
+#define ST7735_TUNE_READ_HZ 2000000 // 읽기는 항상 느린 속도로
+
+static bool autotune;
+module_param(autotune, bool, 0444);
+MODULE_PARM_DESC(autotune, "raise the SPI clock at probe while RAMRD read-back matches");
+
+static unsigned int autotune_max_hz;
+module_param(autotune_max_hz, uint, 0444);
+MODULE_PARM_DESC(autotune_max_hz, "autotune upper bound in Hz (0 = controller max)");
+
 static void update_st7735_lcd(struct fb_info *info, struct list_head *pagelist);
 
-static struct st7735_priv {
+/*
+ * vmem(리틀엔디안 RGB565) -> 전송 버퍼 변환 방법
+ * LCD는 픽셀을 상위 바이트부터 받음
+ *  - spi16: 16비트 word로 전송 -> 컨트롤러가 상위 바이트부터 내보냄, 변환 없이 memcpy
+ *  - neon / scalar: 8비트 전송, 바이트 스왑 필요
+ */
+struct st7735_copy {
+    const char *name;
+    void (*fn)(u16 *dst, const u16 *src, int stride, int w, int h);
+    u8 bits_per_word;
+};
+
+/*
+ * spi_async로 보내는 메시지 하나 (명령 1바이트, 파라미터, 픽셀 chunk)
+ * DC 핀은 SPI 전송이 아니라 GPIO라서, 메시지 사이 (버스가 쉬는 동안)에만 바꿀 수 있음
+ * -> 한번에 하나씩만 보내고 완료 콜백에서 DC 바꾼 뒤 다음 메시지 시작
+ *
+ * buf는 probe에서 한번 할당 (flush 중에는 할당 안함)
+ * GFP_DMA: Pi 4의 SPI DMA는 하위 1GB만 접근 가능 -> vmem(vzalloc)은 DMA 불가
+ */
+struct st7735_seg {
+    struct st7735_priv *priv;
+    void *buf;
+    struct spi_transfer xfer;
+    struct spi_message msg;
+    struct completion done;
+    struct list_head node; // 전송 대기 queue
+    int dc;    // 0: command, 1: data
+    bool busy; // 보내는 중 (queue에 있거나 전송 중)
+    u64 t0;    // spi_async 시각 (debugfs 지연 통계)
+
+    // 한 flush의 마지막 메시지: 완료 시 flush 시간 기록
+    bool frame_end;
+    u64 frame_t0;
+};
+
+/* autotune 결과 (sysfs autotune) */
+enum st7735_tune {
+    ST7735_TUNE_OFF,         // autotune=0, DT의 spi-max-frequency 그대로
+    ST7735_TUNE_NO_READBACK, // 읽기 불가 (MISO 미연결 등), DT 값 유지
+    ST7735_TUNE_DONE,
+};
+
+/* 패널 절전 상태 (sysfs idle_timeout_ms, sleep_timeout_ms) */
+enum st7735_power {
+    ST7735_ACTIVE,
+    ST7735_IDLE,  // IDMON: 8색 표시, 소비전력 감소
+    ST7735_SLEEP, // SLPIN + 백라이트 끔
+};
+
+struct st7735_priv {
     struct spi_device *spi;
     struct gpio_desc *reset; // BCM 22
     struct gpio_desc *dc; // BCM 17
@@ -28,8 +120,59 @@ static struct st7735_priv {
     //frame buffer
     struct fb_info *info;
     u8 *vmem;
+
+    // deferred io 콜백과 ioctl flush 직렬화 (win/tx 버퍼 공유)
+    struct mutex flush_lock;
+
+    // 전송 queue: 완료 콜백이 다음 메시지를 꺼내서 보냄
+    spinlock_t q_lock;
+    struct list_head q;
+    bool q_running;
+
+    // 주소창 명령 (CASET, RASET, RAMWR), 영역마다 번갈아 사용
+    u8 *win_param;
+    struct st7735_seg win[2][5];
+    int win_cur;
+
+    // 픽셀 chunk: 하나가 전송되는 동안 다음 chunk 변환
+    struct st7735_seg tx[ST7735_NR_CHUNKS];
+    int tx_cur;
+
+    const struct st7735_copy *copy; // probe에서 벤치마크로 선택
+
+    enum st7735_tune tune;
+
+    // 장치마다 따로 (sysfs refresh_delay_ms로 변경)
+    struct fb_deferred_io defio;
+
+    // 절전: 마지막 flush 이후 timeout 지나면 power_work가 IDMON / SLPIN
+    // power, last_flush는 flush_lock으로 보호
+    struct delayed_work power_work;
+    enum st7735_power power;
+    unsigned long last_flush; // jiffies
+    unsigned int idle_timeout_ms; // 0: 사용 안함
+    unsigned int sleep_timeout_ms;
+
+    // 통계 (q_lock으로 보호, frame_t0만 flush_lock)
+    u64 frame_t0;
+    u64 frames;
+    u64 bytes;
+    u64 flush_ns_min;
+    u64 flush_ns_max;
+    u64 flush_ns_sum;
+
+    struct jmw_stats stats; // 메시지 단위 (debugfs st7735:<spi dev>)
 };
 
+static void st7735_seg_init(struct st7735_priv *priv, struct st7735_seg *seg, void *buf);
+static void st7735_seg_submit(struct st7735_seg *seg, int len, int dc, u8 bits_per_word);
+static void st7735_seg_wait(struct st7735_seg *seg);
+static void st7735_seg_wait_all(struct st7735_priv *priv);
+static void st7735_pick_copy(struct st7735_priv *priv);
+static int st7735_fb_ioctl(struct fb_info *info, unsigned int cmd, unsigned long arg);
+static void st7735_power_work(struct work_struct *work);
+static void st7735_power_schedule(struct st7735_priv *priv);
+
 static struct fb_ops st7735_fb_ops = {
     .owner      = THIS_MODULE,
     .fb_read    = fb_sys_read,   // 표준 읽기
@@ -37,10 +180,12 @@ static struct fb_ops st7735_fb_ops = {
     .fb_fillrect= cfb_fillrect,  // cfb: vmem에 사각형 그리기
     .fb_copyarea= cfb_copyarea,  // cfb: vmem 영역 복사
     .fb_imageblit = cfb_imageblit, // cfb: vmem에 이미지 그리기
+    .fb_ioctl   = st7735_fb_ioctl, // ST7735IO_DIRTYFB (st7735.h)
+    .fb_compat_ioctl = st7735_fb_ioctl, // 구조체가 32/64비트 동일
 };
 
-/* 타이머 설정 */
-static struct fb_deferred_io st7735_defio = {
+/* 타이머 설정 (probe에서 장치마다 복사) */
+static const struct fb_deferred_io st7735_defio = {
     .delay          = HZ / 30, // 30 FPS (초당 30번)
     .deferred_io    = update_st7735_lcd, // 4-2 함수를 호출
 };
@@ -60,73 +205,257 @@ static void st7735_write_data(struct st7735_priv *priv, const char *buf, size_t
     spi_write(priv->spi, buf, len); // 쓰기모드에서 buf데이터를 len크기만큼 write
 }
 
-static void st7735_hw_init(struct st7735_priv *priv)
-{
-    /* 1. 물리적 리셋 */
-    gpiod_set_value(priv->reset, 0); mdelay(10);
-    gpiod_set_value(priv->reset, 1); mdelay(120);
+/*
+ * 초기화 명령 테이블 (Adafruit ST7735 라이브러리와 같은 형식)
+ *  [명령 수] 다음에 명령마다
+ *  [cmd] [파라미터 수 | ST7735_INIT_DELAY] [파라미터...] [delay ms (DELAY일 때만, 255 = 500ms)]
+ * DT의 init-sequence (u8 배열, 같은 형식)로 바꿀 수 있음
+ */
+#define ST7735_INIT_DELAY 0x80
 
-    /* 2. 소프트웨어 리셋 (0x01) */
-    st7735_write_cmd(priv, 0x01); 
-    mdelay(150); 
+static const u8 st7735_init_seq[] = {
+    13,
+    0x01, ST7735_INIT_DELAY, 120,       // SWRESET (SLPOUT 전 120ms)
+    0x11, ST7735_INIT_DELAY, 120,       // SLPOUT (다음 명령까지 120ms)
+    0x38, 0,                            // IDMOFF (Idle Mode Off)
+    0xB1, 3, 0x01, 0x2C, 0x2D,          // FRMCTR1 프레임 레이트 (normal)
+    0xB2, 3, 0x01, 0x2C, 0x2D,          // FRMCTR2 (idle mode)
+    0xB3, 6, 0x01, 0x2C, 0x2D, 0x01, 0x2C, 0x2D, // FRMCTR3 (partial mode)
+    0xB4, 1, 0x07,                      // INVCTR 디스플레이 인버전
+    0xC0, 3, 0xA2, 0x02, 0x84,          // PWCTR1 내부 전압
+    0xC1, 1, 0xC5,                      // PWCTR2
+    0xC5, 1, 0x0E,                      // VMCTR1 공통 전극 전압
+    0x3A, 1, 0x05,                      // COLMOD 16bpp (RGB565)
+    0x36, 1, 0xC0,                      // MADCTL 방향 (BGR 비트 = 0)
+    0x29, ST7735_INIT_DELAY, 100,       // DISPON
+};
 
-    /* 3. 슬립 아웃 (0x11) */
-    st7735_write_cmd(priv, 0x11); 
-    mdelay(500);
+/*
+ * 초기화 테이블 실행
+ * 명령/파라미터를 전부 전송 queue에 넣고 (spi_write 한번씩 기다리지 않음)
+ * delay가 있는 명령에서만 전송 완료를 기다린 뒤 msleep
+ *
+ * DC는 메시지 단위로만 바꿀 수 있음 -> 명령 바이트(DC low)만 이어서 한 메시지로 묶음
+ *  파라미터 없는 명령이 연속되면 다음 명령 바이트까지 한 메시지, 파라미터 블록은 따로
+ *  명령 바이트는 테이블 복사본 안에서 앞으로 당겨 모음 (읽는 위치보다 항상 앞이라 안전)
+ */
+static int st7735_run_init(struct st7735_priv *priv, const u8 *table, size_t len) {
+    struct st7735_seg *segs, *last = NULL;
+    size_t pos = 1, run = 1; // run: 모으는 중인 명령 바이트 시작
+    int count, nseg = 0, nrun = 0;
+    int ret = 0;
+    u8 *buf;
 
-    st7735_write_cmd(priv, 0x38); // IDMOFF (Idle Mode Off)
-    mdelay(10);
+    if (len < 1)
+        return -EINVAL;
+    count = table[0];
 
-    /* 4. 프레임 레이트 제어 (0xB1) - 필수! */
-    st7735_write_cmd(priv, 0xB1); // FRMCTR1
-    u8 frmctr1[] = { 0x01, 0x2C, 0x2D };
-    st7735_write_data(priv, frmctr1, 3);
-    
-    st7735_write_cmd(priv, 0xB2); // FRMCTR2 (idle mode)
-    u8 frmctr2[] = { 0x01, 0x2C, 0x2D };
-    st7735_write_data(priv, frmctr2, 3);
-    
-    st7735_write_cmd(priv, 0xB3); // FRMCTR3 (partial mode)
-    u8 frmctr3[] = { 0x01, 0x2C, 0x2D, 0x01, 0x2C, 0x2D };
-    st7735_write_data(priv, frmctr3, 6);
-
-    /* 5. 디스플레이 인버전 제어 (0xB4) */
-    st7735_write_cmd(priv, 0xB4); // INVCTR
-    u8 invctr[] = { 0x07 };
-    st7735_write_data(priv, invctr, 1);
-    
-    /* 6. 파워 컨트롤 1 (0xC0) - 필수! 내부 전압 설정 */
-    st7735_write_cmd(priv, 0xC0); // PWCTR1
-    u8 pwctr1[] = { 0xA2, 0x02, 0x84 };
-    st7735_write_data(priv, pwctr1, 3);
-    
-    /* 7. 파워 컨트롤 2 (0xC1) */
-    st7735_write_cmd(priv, 0xC1); // PWCTR2
-    u8 pwctr2[] = { 0xC5 };
-    st7735_write_data(priv, pwctr2, 1);
-    
-    /* 8. VCOM 제어 1 (0xC5) - 필수! 공통 전극 전압 설정 */
-    st7735_write_cmd(priv, 0xC5); // VMCTR1
-    u8 vmctr1[] = { 0x0E };
-    st7735_write_data(priv, vmctr1, 1);
-
-    /* 9. 픽셀 포맷 (0x3A) */
-    st7735_write_cmd(priv, 0x3A); // COLMOD
-    u8 colmod[] = { 0x05 }; // 0x05 = 16bpp (RGB565)
-    st7735_write_data(priv, colmod, 1);
-
-    /* 10. 메모리 접근 제어 (0x36) - 노이즈/방향 해결용 */
-    st7735_write_cmd(priv, 0x36); // MADCTL
-    u8 madctl[] = { 0xC0 }; // (BGR 비트 = 0)
-    st7735_write_data(priv, madctl, 1);
-
-    st7735_write_cmd(priv, 0x28); // DISPOFF (화면을 끈 상태로 설정)
-    st7735_write_cmd(priv, 0x29); // DISPON (화면을 켬)
-    mdelay(100);
-
-    /* 12. 백라이트 ON (모든 준비 완료) */
+    buf = kmemdup(table, len, GFP_KERNEL | GFP_DMA); // 전송용 복사본 (DMA 가능)
+    segs = kcalloc(2 * count, sizeof(*segs), GFP_KERNEL); // 명령, 파라미터
+    if (buf == NULL || segs == NULL) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    for (int i = 0; i < count; i++) {
+        int nargs, delay;
+
+        if (pos + 2 > len) {
+            ret = -EINVAL;
+            break;
+        }
+        nargs = buf[pos + 1] & ~ST7735_INIT_DELAY;
+        delay = buf[pos + 1] & ST7735_INIT_DELAY;
+        if (pos + 2 + nargs + (delay ? 1 : 0) > len) {
+            ret = -EINVAL;
+            break;
+        }
+
+        if (nrun == 0)
+            run = pos;
+        buf[run + nrun++] = buf[pos];
+
+        // 파라미터나 delay가 있으면 여기까지 모은 명령 바이트를 보냄
+        if (nargs > 0 || delay) {
+            last = &segs[nseg++];
+            st7735_seg_init(priv, last, &buf[run]);
+            st7735_seg_submit(last, nrun, 0, 8);
+            nrun = 0;
+        }
+        if (nargs > 0) {
+            last = &segs[nseg++];
+            st7735_seg_init(priv, last, &buf[pos + 2]);
+            st7735_seg_submit(last, nargs, 1, 8);
+        }
+        pos += 2 + nargs;
+
+        if (delay) {
+            int ms = buf[pos++];
+
+            st7735_seg_wait(last); // 순서대로 전송 -> 앞의 명령 전부 완료
+            msleep(ms == 255 ? 500 : ms);
+        }
+    }
+
+    if (nrun > 0 && ret == 0) { // 마지막이 파라미터 없는 명령
+        last = &segs[nseg++];
+        st7735_seg_init(priv, last, &buf[run]);
+        st7735_seg_submit(last, nrun, 0, 8);
+    }
+
+out:
+    if (last != NULL)
+        st7735_seg_wait(last);
+    if (ret == -EINVAL)
+        pr_err("st7735_custom: bad init sequence at byte %zu\n", pos);
+    kfree(segs);
+    kfree(buf);
+    return ret;
+}
+
+static int st7735_hw_init(struct st7735_priv *priv, const u8 *seq, size_t len)
+{
+    int ret;
+
+    /* 1. 물리적 리셋 */
+    gpiod_set_value(priv->reset, 0);
+    msleep(10);
+    gpiod_set_value(priv->reset, 1);
+    msleep(120);
+
+    /* 2. 초기화 명령 (SWRESET, SLPOUT, 프레임 레이트, 전압, 픽셀 포맷, DISPON ...) */
+    ret = st7735_run_init(priv, seq, len);
+    if (ret < 0)
+        return ret;
+
+    /* 3. 백라이트 ON (모든 준비 완료) */
     gpiod_set_value(priv->bl, 1);
     pr_info("st7735_custom: Backlight ON (Full Init)\n");
+    return 0;
+}
+
+// 화면 좌표 (0, 0) 부터 w x h 영역을 주소창으로 (동기, probe 전용)
+static void st7735_write_window(struct st7735_priv *priv, int w, int h) {
+    u8 caset[4];
+    u8 raset[4];
+
+    st7735_encode_window(caset, raset, X_OFFSET, Y_OFFSET, X_OFFSET + w - 1, Y_OFFSET + h - 1);
+
+    st7735_write_cmd(priv, 0x2A); // CASET
+    st7735_write_data(priv, caset, 4);
+    st7735_write_cmd(priv, 0x2B); // RASET
+    st7735_write_data(priv, raset, 4);
+}
+
+/*
+ * 명령 1바이트 보내고 len 바이트 읽기 (항상 ST7735_TUNE_READ_HZ)
+ * 읽는 동안에도 DC는 command (MIPI DBI type C 읽기 방식)
+ * @buf: DMA 가능 버퍼, buf[0]에 명령, buf[1..len]에 읽은 값
+ */
+static int st7735_read(struct st7735_priv *priv, u8 cmd, u8 *buf, size_t len) {
+    struct spi_transfer xfer[2] = {
+        { .tx_buf = buf, .len = 1, .speed_hz = ST7735_TUNE_READ_HZ },
+        { .rx_buf = buf + 1, .len = len, .speed_hz = ST7735_TUNE_READ_HZ },
+    };
+    struct spi_message msg;
+
+    buf[0] = cmd;
+    spi_message_init_with_transfers(&msg, xfer, 2);
+    gpiod_set_value(priv->dc, 0);
+    return spi_sync(priv->spi, &msg);
+}
+
+/*
+ * 테스트 패턴을 현재 spi->max_speed_hz로 쓰고 느린 속도로 다시 읽음
+ * 읽은 값의 형식 (더미, 18비트 변환)은 해석하지 않음
+ * -> 느린 속도로 쓴 기준값과 바이트 단위로 비교
+ */
+static int st7735_tune_write_read(struct st7735_priv *priv, bool invert, u8 *rx) {
+    u16 *pattern = priv->tx[0].buf; // DMA 가능, 아직 flush 전이라 사용 가능
+
+    for (int i = 0; i < ST7735_TUNE_PIXELS; i++) {
+        u16 v = (i * 0x9E37) ^ (i << 7) ^ 0x5A5A; // 비트 변화가 많은 패턴
+
+        pattern[i] = invert ? ~v : v;
+    }
+
+    st7735_write_window(priv, ST7735_TUNE_W, ST7735_TUNE_H);
+    st7735_write_cmd(priv, 0x2C); // RAMWR
+    st7735_write_data(priv, (const char *)pattern, ST7735_TUNE_PIXELS * 2);
+
+    return st7735_read(priv, 0x2E, rx, ST7735_TUNE_RDLEN); // RAMRD
+}
+
+static bool st7735_tune_check(struct st7735_priv *priv, u8 *rx, const u8 *ref0, const u8 *ref1) {
+    return st7735_tune_write_read(priv, false, rx) == 0 &&
+           memcmp(rx + 1, ref0 + 1, ST7735_TUNE_RDLEN) == 0 &&
+           st7735_tune_write_read(priv, true, rx) == 0 &&
+           memcmp(rx + 1, ref1 + 1, ST7735_TUNE_RDLEN) == 0;
+}
+
+/*
+ * SPI 클럭 autotune (autotune=1 일때만)
+ * DT의 spi-max-frequency부터 25%씩 올려가며 패턴 쓰기 -> read-back 비교
+ * 처음 실패하면 멈추고, 여유를 두고 통과한 최고 속도의 한 단계 아래 사용
+ * 읽기가 안되는 배선이면 (패턴이 바뀌어도 읽은 값이 같음) DT 값 유지
+ */
+static void st7735_autotune(struct st7735_priv *priv) {
+    struct spi_device *spi = priv->spi;
+    u32 base = spi->max_speed_hz;
+    u32 limit = autotune_max_hz ? autotune_max_hz : spi->controller->max_speed_hz;
+    u32 pass = base, prev_pass = base;
+    u32 speed = base;
+    u8 *ref0, *ref1, *rx;
+
+    if (!autotune)
+        return;
+    if (limit == 0)
+        limit = base * 4;
+
+    ref0 = kmalloc(3 * (ST7735_TUNE_RDLEN + 1), GFP_KERNEL | GFP_DMA);
+    if (ref0 == NULL)
+        return;
+    ref1 = ref0 + ST7735_TUNE_RDLEN + 1;
+    rx = ref1 + ST7735_TUNE_RDLEN + 1;
+
+    // 기준값: 지금 쓰고 있는 DT 속도로 쓰고 읽은 값
+    if (st7735_tune_write_read(priv, false, ref0) < 0 ||
+        st7735_tune_write_read(priv, true, ref1) < 0 ||
+        memcmp(ref0 + 1, ref1 + 1, ST7735_TUNE_RDLEN) == 0) {
+        pr_info("st7735_custom: autotune: no read-back, keep %u Hz\n", base);
+        priv->tune = ST7735_TUNE_NO_READBACK;
+        goto out;
+    }
+
+    while (speed < limit) {
+        bool ok;
+
+        speed = min(speed + speed / 4, limit);
+        spi->max_speed_hz = speed;
+        if (spi_setup(spi) < 0)
+            break;
+
+        ok = st7735_tune_check(priv, rx, ref0, ref1);
+        pr_info("st7735_custom: autotune %u Hz: %s\n", speed, ok ? "ok" : "fail");
+        if (!ok)
+            break;
+
+        prev_pass = pass;
+        pass = speed;
+    }
+
+    spi->max_speed_hz = prev_pass; // 여유: 통과한 최고 속도의 한 단계 아래
+    spi_setup(spi);
+    priv->tune = ST7735_TUNE_DONE;
+    pr_info("st7735_custom: autotune: %u Hz (max pass %u Hz, DT %u Hz)\n", prev_pass, pass, base);
+
+out:
+    // 테스트 영역 지우기
+    memset(priv->tx[0].buf, 0, ST7735_TUNE_PIXELS * 2);
+    st7735_write_window(priv, ST7735_TUNE_W, ST7735_TUNE_H);
+    st7735_write_cmd(priv, 0x2C); // RAMWR
+    st7735_write_data(priv, priv->tx[0].buf, ST7735_TUNE_PIXELS * 2);
+    kfree(ref0);
 }
 
 // spi드라이버를 디바이스에 바인딩
@@ -134,6 +463,7 @@ static int st7735_custom_probe(struct spi_device *spi) {
     struct device *dev = &spi->dev;
     struct st7735_priv *priv;
     struct fb_info *info;
+    int seq_len;
     int ret;
     printk(KERN_INFO "probe function called\n");
 
@@ -154,24 +484,55 @@ static int st7735_custom_probe(struct spi_device *spi) {
 
     spi_set_drvdata(spi, priv);
 
-    gpiod_set_value(priv->reset, 0);
-    mdelay(100);
-    gpiod_set_value(priv->reset, 1);
-    mdelay(100);
-
-    st7735_write_cmd(priv, 0x01); // SWRESET
-    mdelay(100); 
-    st7735_write_cmd(priv, 0x11); // SLPOUT
-    mdelay(100);
-
-    st7735_write_cmd(priv, 0x3A);
-    u8 colmod[] = {0x05};
-    st7735_write_data(priv, colmod, 1);
-
     // frame buffer 등록
     int vmem_size = LCD_WIDTH * LCD_HEIGHT * 2;
     priv->vmem = vzalloc(vmem_size); // ram 공간 할당
     
+    // 전송 버퍼 (flush 중에는 할당하지 않음)
+    mutex_init(&priv->flush_lock);
+    INIT_DELAYED_WORK(&priv->power_work, st7735_power_work);
+    priv->flush_ns_min = U64_MAX;
+    if (jmw_stats_init(&priv->stats, "st7735", dev_name(dev)) < 0) {
+        vfree(priv->vmem);
+        framebuffer_release(info);
+        return -ENOMEM;
+    }
+    spin_lock_init(&priv->q_lock);
+    INIT_LIST_HEAD(&priv->q);
+    priv->win_param = devm_kmalloc(dev, 2 * ST7735_WIN_PARAM, GFP_KERNEL | GFP_DMA);
+    if (priv->win_param == NULL) {
+        printk(KERN_ERR "window buffer alloc err\n");
+        jmw_stats_free(&priv->stats);
+        vfree(priv->vmem);
+        framebuffer_release(info);
+        return -ENOMEM;
+    }
+    for (int i = 0; i < 2; i++) {
+        u8 *param = priv->win_param + i * ST7735_WIN_PARAM;
+
+        param[0] = 0x2A; // CASET
+        param[5] = 0x2B; // RASET
+        param[10] = 0x2C; // RAMWR
+        st7735_seg_init(priv, &priv->win[i][0], &param[0]);
+        st7735_seg_init(priv, &priv->win[i][1], &param[1]);
+        st7735_seg_init(priv, &priv->win[i][2], &param[5]);
+        st7735_seg_init(priv, &priv->win[i][3], &param[6]);
+        st7735_seg_init(priv, &priv->win[i][4], &param[10]);
+    }
+    for (int i = 0; i < ST7735_NR_CHUNKS; i++) {
+        void *buf = devm_kmalloc(dev, ST7735_CHUNK_SIZE, GFP_KERNEL | GFP_DMA);
+
+        if (buf == NULL) {
+            printk(KERN_ERR "tx buffer alloc err\n");
+            jmw_stats_free(&priv->stats);
+            vfree(priv->vmem);
+            framebuffer_release(info);
+            return -ENOMEM;
+        }
+        st7735_seg_init(priv, &priv->tx[i], buf);
+    }
+    st7735_pick_copy(priv);
+
     info->screen_base = (char __iomem *)priv->vmem;
     info->fix.smem_start = (unsigned long)priv->vmem;
     info->fix.smem_len = vmem_size;
@@ -190,22 +551,60 @@ static int st7735_custom_probe(struct spi_device *spi) {
 
     // 4-3. 콜백(fb_ops) 및 타이머(deferred_io) 연결
     info->fbops = &st7735_fb_ops;
-    info->fbdefio = &st7735_defio;
+    priv->defio = st7735_defio;
+    info->fbdefio = &priv->defio;
     fb_deferred_io_init(info);
     
     info->pseudo_palette = devm_kmalloc_array(dev, 16, sizeof(u32), GFP_KERNEL);
     if (info->pseudo_palette == NULL) {
         printk(KERN_ERR "pseudo_palette alloc err\n");
+        fb_deferred_io_cleanup(info);
+        jmw_stats_free(&priv->stats);
+        vfree(priv->vmem);
+        framebuffer_release(info);
         return -1;
     }
 
-    st7735_hw_init(priv);
+    // DT에 init-sequence가 있으면 기본 테이블 대신 사용
+    seq_len = device_property_count_u8(dev, "init-sequence");
+    if (seq_len > 0) {
+        u8 *seq = devm_kmalloc(dev, seq_len, GFP_KERNEL);
+
+        if (seq == NULL || device_property_read_u8_array(dev, "init-sequence", seq, seq_len) < 0) {
+            printk(KERN_ERR "init-sequence read err\n");
+            fb_deferred_io_cleanup(info);
+            jmw_stats_free(&priv->stats);
+            vfree(priv->vmem);
+            framebuffer_release(info);
+            return -EINVAL;
+        }
+        ret = st7735_hw_init(priv, seq, seq_len);
+    } else {
+        ret = st7735_hw_init(priv, st7735_init_seq, sizeof(st7735_init_seq));
+    }
+    if (ret < 0) {
+        printk(KERN_ERR "lcd init err\n");
+        fb_deferred_io_cleanup(info);
+        st7735_seg_wait_all(priv); // 실패 전에 queue에 넣은 init 명령
+        jmw_stats_free(&priv->stats);
+        vfree(priv->vmem);
+        framebuffer_release(info);
+        return ret;
+    }
+    st7735_autotune(priv);
     memset(priv->vmem, 0x00, vmem_size);
     gpiod_set_value(priv->bl, 1);
+    priv->power = ST7735_ACTIVE;
+    priv->last_flush = jiffies;
     
     ret = register_framebuffer(info);
     if (ret < 0) {
         pr_err("st7735_custom: Failed to register framebuffer (err %d)\n", ret);
+        fb_deferred_io_cleanup(info);
+        st7735_seg_wait_all(priv); // init / autotune 전송
+        jmw_stats_free(&priv->stats);
+        vfree(priv->vmem);
+        framebuffer_release(info);
         return -1;
     }
 
@@ -216,14 +615,242 @@ static int st7735_custom_probe(struct spi_device *spi) {
 static void st7735_custom_remove(struct spi_device *spi) {
     struct st7735_priv *priv = spi_get_drvdata(spi);
     gpiod_set_value(priv->bl, 0); // 백라이트 끄기
-    fb_deferred_io_cleanup(priv->info);
+
+    // 먼저 등록 해제 -> 이후로는 ioctl / deferred io가 새 flush를 시작하지 않음
     unregister_framebuffer(priv->info);
+    fb_deferred_io_cleanup(priv->info);
+
+    // 해제 전에 들어온 ioctl flush가 끝나길 기다림 (frame_end에서 power_work를 다시 예약)
+    mutex_lock(&priv->flush_lock);
+    mutex_unlock(&priv->flush_lock);
+    cancel_delayed_work_sync(&priv->power_work);
+    st7735_seg_wait_all(priv); // 마지막 flush 전송 완료 대기
+    jmw_stats_free(&priv->stats); // 완료 콜백 (st7735_seg_complete)이 더 이상 없을때
     vfree(priv->vmem); // "가짜 캔버스" 메모리 해제
     framebuffer_release(priv->info); // "신청서" 메모리 해제
 
     printk(KERN_INFO "Remove func success\n");
 }
 
+/*
+ * 마지막 flush 이후 timeout이 지나면 IDMON / SLPIN
+ * 다음 flush (st7735_frame_begin)에서 깨어남
+ */
+static void st7735_power_work(struct work_struct *work) {
+    struct st7735_priv *priv = container_of(to_delayed_work(work), struct st7735_priv, power_work);
+    unsigned int idle_ms = READ_ONCE(priv->idle_timeout_ms);
+    unsigned int sleep_ms = READ_ONCE(priv->sleep_timeout_ms);
+    unsigned int elapsed;
+
+    mutex_lock(&priv->flush_lock);
+    st7735_seg_wait_all(priv); // 동기 명령 전에 queue 비우기
+    elapsed = jiffies_to_msecs(jiffies - priv->last_flush);
+
+    if (sleep_ms != 0 && elapsed >= sleep_ms) {
+        if (priv->power != ST7735_SLEEP) {
+            gpiod_set_value(priv->bl, 0);
+            st7735_write_cmd(priv, 0x10); // SLPIN
+            priv->power = ST7735_SLEEP;
+        }
+    } else if (idle_ms != 0 && elapsed >= idle_ms) {
+        if (priv->power == ST7735_ACTIVE) {
+            st7735_write_cmd(priv, 0x39); // IDMON
+            priv->power = ST7735_IDLE;
+        }
+    }
+
+    st7735_power_schedule(priv); // 다음 단계 (idle -> sleep)
+    mutex_unlock(&priv->flush_lock);
+}
+
+/*
+ * sysfs: /sys/bus/spi/devices/spi0.0/
+ *  refresh_delay_ms   deferred io 주기 (기본 33, 1 ~ 1000)
+ *  idle_timeout_ms    마지막 flush 후 IDMON 까지 (0: 사용 안함)
+ *  sleep_timeout_ms   마지막 flush 후 SLPIN + 백라이트 끔 까지 (0: 사용 안함)
+ *  power_state        active / idle / sleep
+ *  spi_speed_hz       전송 속도 (autotune 결과)
+ *  autotune           off / no-readback / done
+ *  frames, bytes      완료된 flush 수, 보낸 바이트 수 (명령 포함)
+ *  flush_min_us, flush_avg_us, flush_max_us
+ *                     flush 시작 ~ 마지막 chunk 전송 완료 시간
+ *  stats_reset        아무 값이나 쓰면 통계 초기화
+ */
+static ssize_t refresh_delay_ms_show(struct device *dev, struct device_attribute *attr, char *buf) {
+    struct st7735_priv *priv = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%u\n", jiffies_to_msecs(READ_ONCE(priv->defio.delay)));
+}
+
+static ssize_t refresh_delay_ms_store(struct device *dev, struct device_attribute *attr,
+                                      const char *buf, size_t count) {
+    struct st7735_priv *priv = dev_get_drvdata(dev);
+    unsigned int ms;
+
+    if (kstrtouint(buf, 0, &ms) < 0 || ms < 1 || ms > 1000)
+        return -EINVAL;
+
+    // 다음 page write부터 적용 (fb_deferred_io가 예약할 때 읽음)
+    WRITE_ONCE(priv->defio.delay, max(msecs_to_jiffies(ms), 1UL));
+    return count;
+}
+static DEVICE_ATTR_RW(refresh_delay_ms);
+
+static ssize_t st7735_timeout_store(struct st7735_priv *priv, unsigned int *timeout,
+                                    const char *buf, size_t count) {
+    unsigned int ms;
+
+    if (kstrtouint(buf, 0, &ms) < 0)
+        return -EINVAL;
+
+    mutex_lock(&priv->flush_lock);
+    WRITE_ONCE(*timeout, ms);
+    st7735_power_schedule(priv);
+    mutex_unlock(&priv->flush_lock);
+    return count;
+}
+
+static ssize_t idle_timeout_ms_show(struct device *dev, struct device_attribute *attr, char *buf) {
+    struct st7735_priv *priv = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%u\n", READ_ONCE(priv->idle_timeout_ms));
+}
+
+static ssize_t idle_timeout_ms_store(struct device *dev, struct device_attribute *attr,
+                                     const char *buf, size_t count) {
+    struct st7735_priv *priv = dev_get_drvdata(dev);
+
+    return st7735_timeout_store(priv, &priv->idle_timeout_ms, buf, count);
+}
+static DEVICE_ATTR_RW(idle_timeout_ms);
+
+static ssize_t sleep_timeout_ms_show(struct device *dev, struct device_attribute *attr, char *buf) {
+    struct st7735_priv *priv = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%u\n", READ_ONCE(priv->sleep_timeout_ms));
+}
+
+static ssize_t sleep_timeout_ms_store(struct device *dev, struct device_attribute *attr,
+                                      const char *buf, size_t count) {
+    struct st7735_priv *priv = dev_get_drvdata(dev);
+
+    return st7735_timeout_store(priv, &priv->sleep_timeout_ms, buf, count);
+}
+static DEVICE_ATTR_RW(sleep_timeout_ms);
+
+static ssize_t power_state_show(struct device *dev, struct device_attribute *attr, char *buf) {
+    static const char * const names[] = {
+        [ST7735_ACTIVE] = "active",
+        [ST7735_IDLE] = "idle",
+        [ST7735_SLEEP] = "sleep",
+    };
+    struct st7735_priv *priv = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%s\n", names[READ_ONCE(priv->power)]);
+}
+static DEVICE_ATTR_RO(power_state);
+
+// 실제 전송 속도 (autotune 결과 또는 DT의 spi-max-frequency)
+static ssize_t spi_speed_hz_show(struct device *dev, struct device_attribute *attr, char *buf) {
+    struct st7735_priv *priv = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%u\n", priv->spi->max_speed_hz);
+}
+static DEVICE_ATTR_RO(spi_speed_hz);
+
+static ssize_t autotune_show(struct device *dev, struct device_attribute *attr, char *buf) {
+    static const char * const names[] = {
+        [ST7735_TUNE_OFF] = "off",
+        [ST7735_TUNE_NO_READBACK] = "no-readback",
+        [ST7735_TUNE_DONE] = "done",
+    };
+    struct st7735_priv *priv = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%s\n", names[priv->tune]);
+}
+static DEVICE_ATTR_RO(autotune);
+
+// 통계 하나 읽기 (q_lock: 완료 콜백이 갱신)
+enum st7735_stat {
+    ST7735_STAT_FRAMES,
+    ST7735_STAT_BYTES,
+    ST7735_STAT_MIN_US,
+    ST7735_STAT_AVG_US,
+    ST7735_STAT_MAX_US,
+};
+
+static u64 st7735_stat_read(struct st7735_priv *priv, enum st7735_stat stat) {
+    unsigned long flags;
+    u64 val = 0;
+
+    spin_lock_irqsave(&priv->q_lock, flags);
+    switch (stat) {
+    case ST7735_STAT_FRAMES:
+        val = priv->frames;
+        break;
+    case ST7735_STAT_BYTES:
+        val = priv->bytes;
+        break;
+    case ST7735_STAT_MIN_US:
+        val = priv->frames ? div_u64(priv->flush_ns_min, 1000) : 0;
+        break;
+    case ST7735_STAT_AVG_US:
+        val = priv->frames ? div64_u64(priv->flush_ns_sum, priv->frames * 1000) : 0;
+        break;
+    case ST7735_STAT_MAX_US:
+        val = div_u64(priv->flush_ns_max, 1000);
+        break;
+    }
+    spin_unlock_irqrestore(&priv->q_lock, flags);
+
+    return val;
+}
+
+#define ST7735_STAT_ATTR(_name, _stat)                                                   \
+static ssize_t _name##_show(struct device *dev, struct device_attribute *attr, char *buf) { \
+    return sysfs_emit(buf, "%llu\n", st7735_stat_read(dev_get_drvdata(dev), _stat));    \
+}                                                                                        \
+static DEVICE_ATTR_RO(_name)
+
+ST7735_STAT_ATTR(frames, ST7735_STAT_FRAMES);
+ST7735_STAT_ATTR(bytes, ST7735_STAT_BYTES);
+ST7735_STAT_ATTR(flush_min_us, ST7735_STAT_MIN_US);
+ST7735_STAT_ATTR(flush_avg_us, ST7735_STAT_AVG_US);
+ST7735_STAT_ATTR(flush_max_us, ST7735_STAT_MAX_US);
+
+static ssize_t stats_reset_store(struct device *dev, struct device_attribute *attr,
+                                 const char *buf, size_t count) {
+    struct st7735_priv *priv = dev_get_drvdata(dev);
+    unsigned long flags;
+
+    spin_lock_irqsave(&priv->q_lock, flags);
+    priv->frames = 0;
+    priv->bytes = 0;
+    priv->flush_ns_sum = 0;
+    priv->flush_ns_min = U64_MAX;
+    priv->flush_ns_max = 0;
+    spin_unlock_irqrestore(&priv->q_lock, flags);
+    return count;
+}
+static DEVICE_ATTR_WO(stats_reset);
+
+static struct attribute *st7735_attrs[] = {
+    &dev_attr_refresh_delay_ms.attr,
+    &dev_attr_idle_timeout_ms.attr,
+    &dev_attr_sleep_timeout_ms.attr,
+    &dev_attr_power_state.attr,
+    &dev_attr_spi_speed_hz.attr,
+    &dev_attr_autotune.attr,
+    &dev_attr_frames.attr,
+    &dev_attr_bytes.attr,
+    &dev_attr_flush_min_us.attr,
+    &dev_attr_flush_avg_us.attr,
+    &dev_attr_flush_max_us.attr,
+    &dev_attr_stats_reset.attr,
+    NULL,
+};
+ATTRIBUTE_GROUPS(st7735);
+
 static const struct of_device_id st7735_custom_id[] = {
     {.compatible = "my-custom,st7735"}, // .dts하고 일치
     {},
@@ -235,6 +862,8 @@ static struct spi_driver st7735_custom_driver = {
     .driver = {
         .name = "st7735_custom",
         .of_match_table = st7735_custom_id,
+        .dev_groups = st7735_groups, // /sys/bus/spi/devices/spi0.0/
+        .probe_type = PROBE_PREFER_ASYNCHRONOUS, // LCD 초기화 (~400ms) 동안 부팅 안 막음
     },
     .probe = st7735_custom_probe,
     .remove = st7735_custom_remove,
@@ -242,63 +871,376 @@ static struct spi_driver st7735_custom_driver = {
 
 
 
-// lcd에 그릴 영역 설정
-static void st7735_set_addr_window(struct st7735_priv *priv, int x, int y, int w, int h) {
-    u8 caset_data[4];
-    u8 raset_data[4];
+static void st7735_seg_init(struct st7735_priv *priv, struct st7735_seg *seg, void *buf) {
+    seg->priv = priv;
+    seg->buf = buf;
+    init_completion(&seg->done);
+}
 
-    int x_start = x + X_OFFSET;
-    int y_start = y + Y_OFFSET;
-    int x_end = x + w - 1 + X_OFFSET;
-    int y_end = y + h - 1 + Y_OFFSET;
+static void st7735_seg_start(struct st7735_seg *seg);
 
-    st7735_write_cmd(priv, 0x2A); // CASET
-    caset_data[0] = (x_start >> 8) & 0xFF;
-    caset_data[1] = x_start & 0xFF;
-    caset_data[2] = (x_end >> 8) & 0xFF;
-    caset_data[3] = x_end & 0xFF;
-    st7735_write_data(priv, caset_data, 4);
+/*
+ * 메시지 전송 완료 (SPI 컨트롤러 쪽 context, sleep 불가)
+ * 대기 중인 다음 메시지가 있으면 DC 바꾸고 바로 시작
+ */
+static void st7735_seg_complete(void *context) {
+    struct st7735_seg *seg = context;
+    struct st7735_priv *priv = seg->priv;
+    struct st7735_seg *next;
+    unsigned long flags;
+
+    jmw_stats_add(&priv->stats, seg->xfer.len, seg->msg.status, ktime_get_ns() - seg->t0);
+
+    spin_lock_irqsave(&priv->q_lock, flags);
+    if (seg->frame_end) {
+        u64 ns = ktime_get_ns() - seg->frame_t0;
+
+        seg->frame_end = false;
+        priv->frames++;
+        priv->flush_ns_sum += ns;
+        priv->flush_ns_min = min(priv->flush_ns_min, ns);
+        priv->flush_ns_max = max(priv->flush_ns_max, ns);
+    }
+    next = list_first_entry_or_null(&priv->q, struct st7735_seg, node);
+    if (next != NULL)
+        list_del(&next->node);
+    else
+        priv->q_running = false;
+    spin_unlock_irqrestore(&priv->q_lock, flags);
+
+    complete(&seg->done);
+
+    if (next != NULL)
+        st7735_seg_start(next);
+}
+
+static void st7735_seg_start(struct st7735_seg *seg) {
+    struct st7735_priv *priv = seg->priv;
+    int ret;
+
+    // 앞 메시지는 끝났고 다음은 아직 시작 전 -> DC 바꿔도 안전
+    // (DC는 BCM GPIO라 atomic context에서도 set 가능)
+    gpiod_set_value(priv->dc, seg->dc);
+
+    seg->t0 = ktime_get_ns();
+    ret = spi_async(priv->spi, &seg->msg);
+    if (ret < 0) {
+        pr_err("st7735: spi_async fail (err %d)\n", ret);
+        seg->msg.status = ret;
+        st7735_seg_complete(seg); // 버리고 다음 메시지 진행
+    }
+}
+
+/*
+ * 메시지를 전송 queue 뒤에 추가
+ * 버스가 놀고 있으면 바로 시작, 아니면 앞 메시지 완료 콜백이 시작함
+ * buf 내용은 완료(st7735_seg_wait)될 때까지 건드리면 안됨
+ */
+static void st7735_seg_submit(struct st7735_seg *seg, int len, int dc, u8 bits_per_word) {
+    struct st7735_priv *priv = seg->priv;
+    unsigned long flags;
+    bool start;
+
+    memset(&seg->xfer, 0, sizeof(seg->xfer));
+    seg->xfer.tx_buf = seg->buf;
+    seg->xfer.len = len;
+    seg->xfer.bits_per_word = bits_per_word;
+    spi_message_init_with_transfers(&seg->msg, &seg->xfer, 1);
+    seg->msg.complete = st7735_seg_complete;
+    seg->msg.context = seg;
+    seg->dc = dc;
+    reinit_completion(&seg->done);
+    seg->busy = true;
+
+    spin_lock_irqsave(&priv->q_lock, flags);
+    priv->bytes += len;
+    start = !priv->q_running;
+    if (start)
+        priv->q_running = true;
+    else
+        list_add_tail(&seg->node, &priv->q);
+    spin_unlock_irqrestore(&priv->q_lock, flags);
+
+    if (start)
+        st7735_seg_start(seg);
+}
+
+// 이 메시지가 끝날때까지 대기 (버퍼 재사용 전)
+static void st7735_seg_wait(struct st7735_seg *seg) {
+    if (!seg->busy)
+        return;
 
-    st7735_write_cmd(priv, 0x2B); //RASET
-    raset_data[0] = (y_start >> 8) & 0xFF;
-    raset_data[1] = y_start & 0xFF;
-    raset_data[2] = (y_end >> 8) & 0xFF;
-    raset_data[3] = y_end & 0xFF;
-    st7735_write_data(priv, raset_data, 4);
+    wait_for_completion(&seg->done);
+    seg->busy = false;
 }
 
-// update_st7735_lcd 함수를 다음과 같이 수정
+static void st7735_seg_wait_all(struct st7735_priv *priv) {
+    int i, j;
+
+    for (i = 0; i < 2; i++)
+        for (j = 0; j < 5; j++)
+            st7735_seg_wait(&priv->win[i][j]);
+    for (i = 0; i < ST7735_NR_CHUNKS; i++)
+        st7735_seg_wait(&priv->tx[i]);
+}
+
+// st7735_copy_swap, st7735_copy_native: st7735_pixel.h
+#ifdef ST7735_NEON
+void st7735_swap16_neon(u16 *dst, const u16 *src, int stride, int w, int h); // 7735_neon.c
+
+static void st7735_copy_neon(u16 *dst, const u16 *src, int stride, int w, int h) {
+    if (!may_use_simd()) {
+        st7735_copy_swap(dst, src, stride, w, h);
+        return;
+    }
+
+    kernel_neon_begin();
+    st7735_swap16_neon(dst, src, stride, w, h);
+    kernel_neon_end();
+}
+#endif
+
+static const struct st7735_copy st7735_copies[] = {
+    { "spi16", st7735_copy_native, 16 },
+#ifdef ST7735_NEON
+    { "neon", st7735_copy_neon, 8 },
+#endif
+    { "scalar", st7735_copy_swap, 8 },
+};
+
+/*
+ * 사용 가능한 변환 방법마다 전체 프레임 변환 시간을 재서 가장 빠른 것 선택
+ * spi16은 컨트롤러가 16비트 word를 지원할때만 (Pi 4 bcm2835는 8비트만 지원 -> neon)
+ */
+static void st7735_pick_copy(struct st7735_priv *priv) {
+    int lines = ST7735_CHUNK_SIZE / (LCD_WIDTH * 2);
+    u64 best_ns = U64_MAX;
+    int i, run;
+
+    for (i = 0; i < ARRAY_SIZE(st7735_copies); i++) {
+        const struct st7735_copy *c = &st7735_copies[i];
+        u64 ns = U64_MAX;
+
+        if (c->bits_per_word != 8 && !spi_is_bpw_supported(priv->spi, c->bits_per_word))
+            continue;
+
+        for (run = 0; run < 8; run++) { // 최소값 사용 (캐시/인터럽트 영향 제거)
+            u64 t0 = ktime_get_ns();
+            int y;
+
+            // flush와 같이 chunk 단위로 전체 프레임 변환
+            for (y = 0; y < LCD_HEIGHT; y += lines)
+                c->fn(priv->tx[0].buf, (const u16 *)priv->vmem + y * LCD_WIDTH, LCD_WIDTH,
+                      LCD_WIDTH, min(lines, LCD_HEIGHT - y));
+            ns = min(ns, ktime_get_ns() - t0);
+        }
+
+        pr_info("st7735_custom: copy %s: %llu ns/frame\n", c->name, ns);
+        if (ns < best_ns) {
+            best_ns = ns;
+            priv->copy = c;
+        }
+    }
+
+    pr_info("st7735_custom: using %s (%u bits/word)\n", priv->copy->name,
+            priv->copy->bits_per_word);
+}
+
+/*
+ * 마지막 flush 이후 가장 가까운 timeout에 power_work 예약
+ * flush_lock 잡고 호출
+ */
+static void st7735_power_schedule(struct st7735_priv *priv) {
+    unsigned int idle_ms = READ_ONCE(priv->idle_timeout_ms);
+    unsigned int sleep_ms = READ_ONCE(priv->sleep_timeout_ms);
+    unsigned int elapsed = jiffies_to_msecs(jiffies - priv->last_flush);
+    unsigned int next = 0;
+
+    if (priv->power == ST7735_ACTIVE && idle_ms > elapsed)
+        next = idle_ms;
+    if (priv->power != ST7735_SLEEP && sleep_ms > elapsed && (next == 0 || sleep_ms < next))
+        next = sleep_ms;
+
+    if (next != 0)
+        mod_delayed_work(system_wq, &priv->power_work, msecs_to_jiffies(next - elapsed));
+}
+
+/*
+ * 절전 상태에서 깨우기
+ * 절전 진입 때 queue를 비웠고 그 뒤 flush가 없었으므로 동기 명령 사용 가능
+ */
+static void st7735_wake(struct st7735_priv *priv) {
+    switch (priv->power) {
+    case ST7735_SLEEP:
+        st7735_write_cmd(priv, 0x11); // SLPOUT
+        msleep(120);
+        gpiod_set_value(priv->bl, 1);
+        fallthrough; // IDMON 상태에서 잠들었을 수 있음
+    case ST7735_IDLE:
+        st7735_write_cmd(priv, 0x38); // IDMOFF
+        break;
+    case ST7735_ACTIVE:
+        break;
+    }
+    priv->power = ST7735_ACTIVE;
+}
+
+// flush 하나의 시작/끝 (flush_lock 잡고 호출)
+static void st7735_frame_begin(struct st7735_priv *priv) {
+    st7735_wake(priv);
+    priv->frame_t0 = ktime_get_ns();
+}
+
+static void st7735_frame_end(struct st7735_priv *priv) {
+    priv->last_flush = jiffies;
+    st7735_power_schedule(priv);
+}
+
+/*
+ * 사각형 영역 하나만 LCD로 전송
+ * 화면 좌표 (x, y) 부터 w x h 픽셀
+ *
+ * CASET/RASET/RAMWR 와 픽셀 chunk를 전부 전송 queue에 넣고 바로 반환
+ * chunk N이 전송되는 동안 chunk N+1 변환 -> CPU 변환과 SPI 전송이 겹침
+ * @last: 이번 flush의 마지막 영역 (마지막 chunk 완료 시 flush 시간 기록)
+ */
+static void st7735_flush_rect(struct st7735_priv *priv, int x, int y, int w, int h, bool last) {
+    struct fb_info *info = priv->info;
+    struct st7735_seg *win = priv->win[priv->win_cur];
+    u8 *param = win[0].buf;
+    int stride = info->fix.line_length / 2; // 한 줄의 픽셀 수
+    int lines = ST7735_CHUNK_SIZE / (w * 2); // chunk 하나의 줄 수
+    int row;
+
+    /* 바뀐 영역만 주소창으로 설정 (두 번 전 영역의 명령이 끝났어야 재사용 가능) */
+    for (int i = 0; i < 5; i++)
+        st7735_seg_wait(&win[i]);
+
+    st7735_encode_window(&param[1], &param[6], x + X_OFFSET, y + Y_OFFSET,
+                         x + w - 1 + X_OFFSET, y + h - 1 + Y_OFFSET);
+
+    st7735_seg_submit(&win[0], 1, 0, 8); // CASET
+    st7735_seg_submit(&win[1], 4, 1, 8);
+    st7735_seg_submit(&win[2], 1, 0, 8); // RASET
+    st7735_seg_submit(&win[3], 4, 1, 8);
+    st7735_seg_submit(&win[4], 1, 0, 8); // RAMWR
+    priv->win_cur ^= 1;
+
+    /* 픽셀 데이터를 chunk 단위로 변환해서 전송 */
+    for (row = 0; row < h; row += lines) {
+        struct st7735_seg *tx = &priv->tx[priv->tx_cur];
+        int n = min(lines, h - row);
+
+        st7735_seg_wait(tx); // NR_CHUNKS 전에 이 버퍼로 보낸 chunk
+
+        /* 전송 형식에 맞게 변환 (probe에서 고른 방법) */
+        priv->copy->fn(tx->buf, (const u16 *)priv->vmem + (y + row) * stride + x, stride, w, n);
+
+        if (last && row + n >= h) {
+            tx->frame_end = true;
+            tx->frame_t0 = priv->frame_t0;
+        }
+
+        st7735_seg_submit(tx, w * n * 2, 1, priv->copy->bits_per_word);
+        priv->tx_cur = (priv->tx_cur + 1) % ST7735_NR_CHUNKS;
+    }
+}
+
+/*
+ * deferred io 콜백
+ * @pagelist: 지난 flush 이후 write된 vmem page 목록
+ * page -> 줄 범위로 바꿔서 연속된 줄끼리 묶어 그 부분만 전송
+ * (page 4KB = 16줄, 한 줄만 바뀌어도 전체 40KB 대신 4KB)
+ */
 static void update_st7735_lcd(struct fb_info *info, struct list_head *pagelist) {
     struct st7735_priv *priv = info->par;
-    u16 *vmem16 = (u16 *)priv->vmem;
-    int total_pixels = info->var.xres * info->var.yres;
-    u16 *buf;
-    int i;
-
-    /* 바이트 스왑을 위한 임시 버퍼 할당 */
-    buf = kmalloc(info->fix.smem_len, GFP_KERNEL);
-    if (!buf) {
-        pr_err("st7735: Failed to allocate swap buffer\n");
-        return;
+    struct fb_deferred_io_pageref *pageref;
+    DECLARE_BITMAP(dirty, LCD_HEIGHT);
+    unsigned int line_length = info->fix.line_length;
+    unsigned int yres = info->var.yres;
+    unsigned int rs, re;
+    int nr = 0, i = 0;
+
+    bitmap_zero(dirty, LCD_HEIGHT);
+    list_for_each_entry(pageref, pagelist, list) {
+        unsigned int start = pageref->offset / line_length;
+        unsigned int end = (pageref->offset + PAGE_SIZE - 1) / line_length; // 포함
+
+        if (start >= yres)
+            continue;
+        if (end >= yres)
+            end = yres - 1;
+        bitmap_set(dirty, start, end - start + 1);
     }
 
-    /* RGB565 바이트 순서 변환 (리틀엔디안 -> 빅엔디안) */
-    for (i = 0; i < total_pixels; i++) {
-        u16 pixel = vmem16[i];
-        buf[i] = (pixel >> 8) | (pixel << 8); // 바이트 스왑
+    for_each_set_bitrange(rs, re, dirty, yres)
+        nr++;
+    if (nr == 0)
+        return;
+
+    /* 연속된 dirty 줄 [rs, re) 마다 한번씩 전송 */
+    mutex_lock(&priv->flush_lock);
+    st7735_frame_begin(priv);
+    for_each_set_bitrange(rs, re, dirty, yres)
+        st7735_flush_rect(priv, 0, rs, info->var.xres, re - rs, ++i == nr);
+    st7735_frame_end(priv);
+    mutex_unlock(&priv->flush_lock);
+
+    /* 마지막 전송은 기다리지 않음 -> 다음 프레임 변환과 겹침 */
+}
+
+/*
+ * ST7735IO_DIRTYFB
+ * 앱이 알려준 영역만 deferred io 타이머를 기다리지 않고 바로 전송
+ * (mmap으로 쓴 page는 deferred io도 나중에 한번 더 보냄)
+ */
+static int st7735_fb_ioctl(struct fb_info *info, unsigned int cmd, unsigned long arg) {
+    struct st7735_priv *priv = info->par;
+    struct st7735_dirty dirty;
+    struct st7735_rect *rects;
+    int i, n = 0;
+
+    if (cmd != ST7735IO_DIRTYFB)
+        return -ENOTTY;
+
+    if (copy_from_user(&dirty, (void __user *)arg, sizeof(dirty)))
+        return -EFAULT;
+    if (dirty.num_rects == 0 || dirty.num_rects > ST7735_DIRTY_MAX_RECTS ||
+        (dirty.flags & ~ST7735_DIRTY_SYNC))
+        return -EINVAL;
+
+    rects = memdup_user(u64_to_user_ptr(dirty.rects), dirty.num_rects * sizeof(*rects));
+    if (IS_ERR(rects))
+        return PTR_ERR(rects);
+
+    /* 화면 밖은 잘라내고 빈 영역은 버림 */
+    for (i = 0; i < dirty.num_rects; i++) {
+        struct st7735_rect r = rects[i];
+
+        if (r.x >= info->var.xres || r.y >= info->var.yres)
+            continue;
+        r.w = min_t(int, r.w, info->var.xres - r.x);
+        r.h = min_t(int, r.h, info->var.yres - r.y);
+        if (r.w == 0 || r.h == 0)
+            continue;
+
+        rects[n++] = r;
     }
 
-    /* LCD의 전체 화면을 주소창으로 설정 */
-    st7735_set_addr_window(priv, 0, 0, info->var.xres, info->var.yres);
-    
-    /* LCD 메모리에 쓰기 시작 */
-    st7735_write_cmd(priv, 0x2C); // RAMWR
+    mutex_lock(&priv->flush_lock);
+    if (n > 0) {
+        st7735_frame_begin(priv);
+        for (i = 0; i < n; i++)
+            st7735_flush_rect(priv, rects[i].x, rects[i].y, rects[i].w, rects[i].h, i == n - 1);
+        st7735_frame_end(priv);
+    }
 
-    /* 변환된 데이터를 SPI로 전송 */
-    gpiod_set_value(priv->dc, 1); // Data 모드
-    spi_write(priv->spi, (u8 *)buf, info->fix.smem_len);
+    if (dirty.flags & ST7735_DIRTY_SYNC)
+        st7735_seg_wait_all(priv);
+    mutex_unlock(&priv->flush_lock);
 
-    kfree(buf);
+    kfree(rects);
+    return 0;
 }
 
 
@@ -0,0 +1,32 @@
+/*
+ * ST7735 RGB565 바이트 스왑 (NEON)
+ * 7735_driver.c에서 kernel_neon_begin() / kernel_neon_end() 사이에서만 호출
+ * 이 파일만 NEON 플래그로 컴파일 (Makefile 참고)
+ */
+#include <asm/neon-intrinsics.h>
+
+void st7735_swap16_neon(u16 *dst, const u16 *src, int stride, int w, int h);
+
+/*
+ * src의 w x h 영역을 dst에 빈틈없이 복사하면서 픽셀마다 바이트 스왑
+ * @stride: src 한 줄의 픽셀 수
+ */
+void st7735_swap16_neon(u16 *dst, const u16 *src, int stride, int w, int h)
+{
+    int row, col;
+
+    for (row = 0; row < h; row++) {
+        const u16 *s = src + row * stride;
+
+        // 한번에 8픽셀 (16바이트) vrev16
+        for (col = 0; col + 8 <= w; col += 8) {
+            uint8x16_t v = vld1q_u8((const u8 *)(s + col));
+
+            vst1q_u8((u8 *)(dst + col), vrev16q_u8(v));
+        }
+        for (; col < w; col++)
+            dst[col] = (s[col] >> 8) | (s[col] << 8);
+
+        dst += w;
+    }
+}
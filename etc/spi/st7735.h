@@ -0,0 +1,45 @@
+#ifndef ST7735_H
+#define ST7735_H
+
+/*
+ * st7735_custom framebuffer 공개 인터페이스 (드라이버, 앱 공용)
+ *
+ * ST7735IO_DIRTYFB: 바뀐 영역을 바로 LCD로 전송 (DRM의 DIRTYFB와 같은 역할)
+ *  - mmap한 /dev/fbN에 그린 뒤 호출
+ *  - deferred io 타이머(최대 33ms)를 기다리지 않음
+ *  - 아무것도 안 바뀌면 호출도 안하면 됨 -> idle 비용 0
+ *
+ *   struct st7735_rect r = { .x = 0, .y = 0, .w = 32, .h = 16 };
+ *   struct st7735_dirty d = { .num_rects = 1, .rects = (uintptr_t)&r };
+ *   ioctl(fd, ST7735IO_DIRTYFB, &d);
+ */
+
+#include <linux/types.h>
+#include <linux/ioctl.h>
+
+#define ST7735_DIRTY_MAX_RECTS 256
+
+#define ST7735_DIRTY_SYNC 0x1 // 전송이 끝날때까지 기다렸다가 반환
+
+/* 화면 좌표, 화면 밖 부분은 잘라냄 */
+struct st7735_rect {
+    __u16 x;
+    __u16 y;
+    __u16 w;
+    __u16 h;
+};
+
+/*
+ * @num_rects: rects 개수 (1 ~ ST7735_DIRTY_MAX_RECTS)
+ * @flags: ST7735_DIRTY_*
+ * @rects: struct st7735_rect 배열의 사용자 주소 (32/64비트 앱 공용으로 __u64)
+ */
+struct st7735_dirty {
+    __u32 num_rects;
+    __u32 flags;
+    __u64 rects;
+};
+
+#define ST7735IO_DIRTYFB _IOW('S', 0x01, struct st7735_dirty)
+
+#endif
@@ -0,0 +1,257 @@
+/*
+ * ST7735 DRM 드라이버 (MIPI DBI helper 기반 tiny driver)
+ * 7735_driver.c (fbdev) 대신 사용, 같은 overlay (my-st7735.dts) 사용
+ * -> st7735_custom.ko 또는 st7735_drm.ko 중 하나만 insmod
+ *
+ * helper가 해주는 것
+ *  - simple display pipe (plane 1, crtc 1, SPI 연결 1)
+ *  - FB_DAMAGE_CLIPS: 바뀐 영역만 전송
+ *  - XRGB8888 -> RGB565 변환, 바이트 스왑 (컨트롤러가 16비트 word 지원하면 생략)
+ *  - GEM shmem 버퍼, PRIME import/export
+ *  - /dev/fbN 에뮬레이션 (기존 fbdev 앱 호환)
+ *
+ * 대상 커널: Raspberry Pi OS 6.6 / 6.12
+ */
+#include <linux/module.h>
+#include <linux/spi/spi.h>
+#include <linux/of.h>
+#include <linux/delay.h>
+#include <linux/gpio/consumer.h>
+#include <linux/property.h>
+#include <linux/version.h>
+
+#include <drm/drm_atomic_helper.h>
+#include <drm/drm_drv.h>
+#include <drm/drm_gem_atomic_helper.h>
+#include <drm/drm_gem_shmem_helper.h>
+#include <drm/drm_managed.h>
+#include <drm/drm_mipi_dbi.h>
+#include <drm/drm_modeset_helper.h>
+#include <video/mipi_display.h>
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 11, 0)
+#include <drm/drm_fbdev_shmem.h>
+#else
+#include <drm/drm_fbdev_generic.h>
+#endif
+
+#define X_OFFSET 2
+#define Y_OFFSET 1
+
+/* ST7735 전용 명령 (나머지는 MIPI DCS 표준) */
+#define ST7735_FRMCTR1 0xB1
+#define ST7735_FRMCTR2 0xB2
+#define ST7735_FRMCTR3 0xB3
+#define ST7735_INVCTR  0xB4
+#define ST7735_PWCTR1  0xC0
+#define ST7735_PWCTR2  0xC1
+#define ST7735_VMCTR1  0xC5
+
+/* MADCTL 비트 */
+#define ST7735_MY 0x80
+#define ST7735_MX 0x40
+#define ST7735_MV 0x20
+
+struct st7735_drm {
+    struct mipi_dbi_dev dbidev; // drm_device 포함
+    struct gpio_desc *bl; // BCM 27 (backlight class 장치가 아니라 GPIO)
+};
+
+static struct st7735_drm *to_st7735_drm(struct drm_device *drm) {
+    return container_of(drm_to_mipi_dbi_dev(drm), struct st7735_drm, dbidev);
+}
+
+/*
+ * 화면 켜기: 7735_driver.c의 st7735_hw_init()과 같은 초기화
+ * 끝나면 mipi_dbi가 현재 화면 전체를 한번 전송
+ */
+static void st7735_drm_pipe_enable(struct drm_simple_display_pipe *pipe,
+                                   struct drm_crtc_state *crtc_state,
+                                   struct drm_plane_state *plane_state) {
+    struct st7735_drm *st = to_st7735_drm(pipe->crtc.dev);
+    struct mipi_dbi_dev *dbidev = &st->dbidev;
+    struct mipi_dbi *dbi = &dbidev->dbi;
+    u8 madctl;
+    int idx;
+
+    if (!drm_dev_enter(pipe->crtc.dev, &idx))
+        return;
+
+    if (mipi_dbi_poweron_reset(dbidev)) // reset 핀 + 120ms
+        goto out_exit;
+
+    msleep(150);
+    mipi_dbi_command(dbi, MIPI_DCS_EXIT_SLEEP_MODE);
+    msleep(500);
+    mipi_dbi_command(dbi, MIPI_DCS_EXIT_IDLE_MODE);
+
+    mipi_dbi_command(dbi, ST7735_FRMCTR1, 0x01, 0x2C, 0x2D);
+    mipi_dbi_command(dbi, ST7735_FRMCTR2, 0x01, 0x2C, 0x2D);
+    mipi_dbi_command(dbi, ST7735_FRMCTR3, 0x01, 0x2C, 0x2D, 0x01, 0x2C, 0x2D);
+    mipi_dbi_command(dbi, ST7735_INVCTR, 0x07);
+    mipi_dbi_command(dbi, ST7735_PWCTR1, 0xA2, 0x02, 0x84);
+    mipi_dbi_command(dbi, ST7735_PWCTR2, 0xC5);
+    mipi_dbi_command(dbi, ST7735_VMCTR1, 0x0E);
+    mipi_dbi_command(dbi, MIPI_DCS_SET_PIXEL_FORMAT, MIPI_DCS_PIXEL_FMT_16BIT);
+
+    // rotation 0 이 fbdev 드라이버와 같은 방향 (MADCTL 0xC0)
+    switch (dbidev->rotation) {
+    default:
+        madctl = ST7735_MY | ST7735_MX;
+        break;
+    case 90:
+        madctl = ST7735_MX | ST7735_MV;
+        break;
+    case 180:
+        madctl = 0;
+        break;
+    case 270:
+        madctl = ST7735_MY | ST7735_MV;
+        break;
+    }
+    mipi_dbi_command(dbi, MIPI_DCS_SET_ADDRESS_MODE, madctl);
+    mipi_dbi_command(dbi, MIPI_DCS_SET_DISPLAY_ON);
+    msleep(100);
+
+    mipi_dbi_enable_flush(dbidev, crtc_state, plane_state);
+    gpiod_set_value(st->bl, 1);
+
+out_exit:
+    drm_dev_exit(idx);
+}
+
+static void st7735_drm_pipe_disable(struct drm_simple_display_pipe *pipe) {
+    struct st7735_drm *st = to_st7735_drm(pipe->crtc.dev);
+
+    gpiod_set_value(st->bl, 0);
+    mipi_dbi_pipe_disable(pipe);
+}
+
+/* DRM_MIPI_DBI_SIMPLE_DISPLAY_PIPE_FUNCS 에서 disable만 backlight GPIO 처리 추가 */
+static const struct drm_simple_display_pipe_funcs st7735_drm_pipe_funcs = {
+    .mode_valid = mipi_dbi_pipe_mode_valid,
+    .enable = st7735_drm_pipe_enable,
+    .disable = st7735_drm_pipe_disable,
+    .update = mipi_dbi_pipe_update, // damage clip 영역만 변환/전송
+    .begin_fb_access = mipi_dbi_pipe_begin_fb_access,
+    .end_fb_access = mipi_dbi_pipe_end_fb_access,
+    .reset_plane = mipi_dbi_pipe_reset_plane,
+    .duplicate_plane_state = mipi_dbi_pipe_duplicate_plane_state,
+    .destroy_plane_state = mipi_dbi_pipe_destroy_plane_state,
+};
+
+// 1.8인치 패널: 128 x 160, 28 x 35 mm
+static const struct drm_display_mode st7735_drm_mode = {
+    DRM_SIMPLE_MODE(128, 160, 28, 35),
+};
+
+DEFINE_DRM_GEM_FOPS(st7735_drm_fops);
+
+static const struct drm_driver st7735_drm_driver = {
+    .driver_features = DRIVER_GEM | DRIVER_MODESET | DRIVER_ATOMIC,
+    .fops = &st7735_drm_fops,
+    DRM_GEM_SHMEM_DRIVER_OPS, // shmem GEM + PRIME
+    .debugfs_init = mipi_dbi_debugfs_init,
+    .name = "st7735_drm",
+    .desc = "ST7735 1.8inch TFT",
+#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 14, 0)
+    .date = "20260101",
+#endif
+    .major = 1,
+    .minor = 0,
+};
+
+// spi드라이버를 디바이스에 바인딩
+static int st7735_drm_probe(struct spi_device *spi) {
+    struct device *dev = &spi->dev;
+    struct st7735_drm *st;
+    struct mipi_dbi_dev *dbidev;
+    struct drm_device *drm;
+    struct gpio_desc *dc;
+    u32 rotation = 0;
+    int ret;
+
+    st = devm_drm_dev_alloc(dev, &st7735_drm_driver, struct st7735_drm, dbidev.drm);
+    if (IS_ERR(st))
+        return PTR_ERR(st);
+
+    dbidev = &st->dbidev;
+    drm = &dbidev->drm;
+
+    // gpio 가져오기 (overlay의 reset/dc/bl-gpios)
+    dbidev->dbi.reset = devm_gpiod_get(dev, "reset", GPIOD_OUT_HIGH);
+    if (IS_ERR(dbidev->dbi.reset))
+        return dev_err_probe(dev, PTR_ERR(dbidev->dbi.reset), "reset gpio\n");
+
+    dc = devm_gpiod_get(dev, "dc", GPIOD_OUT_LOW);
+    if (IS_ERR(dc))
+        return dev_err_probe(dev, PTR_ERR(dc), "dc gpio\n");
+
+    st->bl = devm_gpiod_get(dev, "bl", GPIOD_OUT_LOW);
+    if (IS_ERR(st->bl))
+        return dev_err_probe(dev, PTR_ERR(st->bl), "bl gpio\n");
+
+    device_property_read_u32(dev, "rotation", &rotation);
+
+    ret = mipi_dbi_spi_init(spi, &dbidev->dbi, dc);
+    if (ret)
+        return ret;
+    dbidev->dbi.read_commands = NULL; // 모듈에 MISO 없음 (쓰기 전용)
+
+    dbidev->left_offset = X_OFFSET;
+    dbidev->top_offset = Y_OFFSET;
+
+    ret = mipi_dbi_dev_init(dbidev, &st7735_drm_pipe_funcs, &st7735_drm_mode, rotation);
+    if (ret)
+        return ret;
+
+    drm_mode_config_reset(drm);
+
+    ret = drm_dev_register(drm, 0);
+    if (ret)
+        return ret;
+
+    spi_set_drvdata(spi, drm);
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 11, 0)
+    drm_fbdev_shmem_setup(drm, 0);
+#else
+    drm_fbdev_generic_setup(drm, 0);
+#endif
+
+    return 0;
+}
+
+// spi드라이버를 디바이스에 언바인딩
+static void st7735_drm_remove(struct spi_device *spi) {
+    struct drm_device *drm = spi_get_drvdata(spi);
+
+    drm_dev_unplug(drm);
+    drm_atomic_helper_shutdown(drm); // 화면 끄기 (disable 호출)
+}
+
+static void st7735_drm_shutdown(struct spi_device *spi) {
+    drm_atomic_helper_shutdown(spi_get_drvdata(spi));
+}
+
+static const struct of_device_id st7735_drm_id[] = {
+    {.compatible = "my-custom,st7735"}, // .dts하고 일치
+    {},
+};
+
+MODULE_DEVICE_TABLE(of, st7735_drm_id);
+
+static struct spi_driver st7735_drm_spi_driver = {
+    .driver = {
+        .name = "st7735_drm",
+        .of_match_table = st7735_drm_id,
+    },
+    .probe = st7735_drm_probe,
+    .remove = st7735_drm_remove,
+    .shutdown = st7735_drm_shutdown,
+};
+
+module_spi_driver(st7735_drm_spi_driver);
+
+MODULE_LICENSE("GPL");
+MODULE_AUTHOR("JIN MINU");
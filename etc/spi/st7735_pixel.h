@@ -0,0 +1,54 @@
+#ifndef ST7735_PIXEL_H
+#define ST7735_PIXEL_H
+
+#include <linux/types.h>
+#include <linux/string.h>
+
+/*
+ * 픽셀 변환 / 주소창 인코딩 (SPI, sleep 없는 순수 계산)
+ * 7735_driver.c와 KUnit 등 하드웨어 없는 테스트에서 같이 사용
+ */
+
+// 8비트 전송용: 픽셀마다 바이트 스왑 (리틀엔디안 -> 빅엔디안)
+static inline void st7735_copy_swap(u16 *dst, const u16 *src, int stride, int w, int h) {
+    int row, col;
+
+    for (row = 0; row < h; row++) {
+        const u16 *s = src + row * stride;
+
+        for (col = 0; col < w; col++)
+            *dst++ = (s[col] >> 8) | (s[col] << 8);
+    }
+}
+
+// 16비트 전송용: 그대로 복사 (전체 폭이면 memcpy 한번)
+static inline void st7735_copy_native(u16 *dst, const u16 *src, int stride, int w, int h) {
+    int row;
+
+    if (w == stride) {
+        memcpy(dst, src, w * h * 2);
+        return;
+    }
+
+    for (row = 0; row < h; row++) {
+        memcpy(dst, src + row * stride, w * 2);
+        dst += w;
+    }
+}
+
+/*
+ * CASET / RASET 파라미터 (시작, 끝 각각 16비트 빅엔디안)
+ * @x0, y0, x1, y1: 패널 좌표 (offset 포함), 끝 포함
+ */
+static inline void st7735_encode_window(u8 *caset, u8 *raset, int x0, int y0, int x1, int y1) {
+    caset[0] = (x0 >> 8) & 0xFF;
+    caset[1] = x0 & 0xFF;
+    caset[2] = (x1 >> 8) & 0xFF;
+    caset[3] = x1 & 0xFF;
+    raset[0] = (y0 >> 8) & 0xFF;
+    raset[1] = y0 & 0xFF;
+    raset[2] = (y1 >> 8) & 0xFF;
+    raset[3] = y1 & 0xFF;
+}
+
+#endif
@@ -1,159 +1,493 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <string.h>
 #include <stdlib.h>
 #include <signal.h>
-#include <sys/shm.h>
-#include <sys/ipc.h>
+#include <stdint.h>
+#include <time.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
 
-void sig_handler(int signo);
+#include "sensord.h"
+#include "loop.h"
+#include "snapshot.h"
+#include "server.h"
+#include "pipeline.h"
+#include "tslog.h"
+#include "rollup.h"
+#include "replay.h"
 
-pid_t pid;
-static int is_running = 1;
+#define SAMPLE_PERIOD_MS 1000 // 기본 센서 측정 주기
+#define MIN_PERIOD_MS 250 // SHT20 온도+습도 측정 시간보다 짧으면 안됨
+#define READY_TIMEOUT_MS 3000 // 드라이버 초기화 대기 (LCD ~50ms, SHT20 ~15ms)
 
-int main(void) {
+/*
+ * sensord
+ * 센서, LCD, 버튼을 이 프로세스 하나가 소유
+ * 다른 프로그램은 /dev/sht20_device를 직접 열지 않고 공유 메모리 snapshot 또는 socket 사용
+ * -> 클라이언트가 늘어도 측정(버스 사용)은 주기당 한번
+ *
+ * 측정/변환/LCD 출력은 pipeline 스레드들이 담당 (pipeline.h)
+ * main 스레드는 event loop만: 시그널, 버튼, socket 클라이언트
+ *
+ * -r: 센서 / 버튼 입력을 파일에 기록
+ * -R: 장치 대신 기록 파일을 재생 (-x 속도, -o 출력 stub), 파일이 끝나면 통계 출력 후 종료
+ */
+struct app {
 	int fd_sensor;
 	int fd_lcd;
-	int fd_btn;
-	char buf[32];
+	int fd_btn; // replay: 재생한 버튼 값이 오는 pipe
+	int fd_btn_w;
 
-	int shmid;
-	char *shmaddr_p = NULL;
-	char *shmaddr_c = NULL;
+	struct loop loop;
+	struct watch w_signal;
+	struct watch w_btn;
+	struct watch w_pub;
+	struct watch w_done;
 
-	signal(SIGINT, sig_handler); // 시그널 핸들러 등록
+	struct snapshot snap;
+	struct server srv;
+	struct pipeline pipe;
+	struct tslog tslog;
+	struct rollup rollup; // event loop 스레드에서만 갱신/검색
+	struct recorder *rec; // NULL이면 기록 안함
+	struct recorder recorder;
+	struct replay replay;
 
-	shmid = shmget(IPC_PRIVATE, sizeof(char), IPC_CREAT|0666);
-	if (shmid < 0) {
-		perror("shmget error\n");
+	int period_ms;
+};
+
+static void set_mode(void *ctx, int mode) {
+	struct app *app = ctx;
+
+	if (pipeline_get_mode(&app->pipe) == mode)
+		return;
+
+	pipeline_set_mode(&app->pipe, mode); // render 스레드가 바로 다시 그림
+	server_set_mode(&app->srv, mode);
+}
+
+static int set_period(void *ctx, int period_ms) {
+	struct app *app = ctx;
+
+	if (period_ms < MIN_PERIOD_MS)
 		return -1;
+
+	return pipeline_set_period(&app->pipe, period_ms);
+}
+
+static int get_stats(void *ctx, char *buf, size_t size) {
+	struct app *app = ctx;
+	struct pipeline_stats st;
+
+	pipeline_stats(&app->pipe, &st);
+	return snprintf(buf, size,
+			"acquired=%lu read_errors=%lu overruns=%lu rendered=%lu coalesced=%lu "
+			"raw_dropped=%lu out_dropped=%lu pub_dropped=%lu logged=%lu log_dropped=%lu",
+			st.acquired, st.read_errors, st.overruns, st.rendered, st.coalesced,
+			st.raw_dropped, st.out_dropped, st.pub_dropped, st.logged, st.log_dropped);
+}
+
+static const struct server_ops app_server_ops = {
+	.set_mode = set_mode,
+	.set_period = set_period,
+	.stats = get_stats,
+};
+
+/*
+ * convert 단계가 pub ring에 넣은 측정값을 rollup에 반영하고 socket 구독자에게 전달
+ */
+static void publish_pending(struct app *app) {
+	struct sensord_sample s;
+
+	while (ring_pop(&app->pipe.pub, &s) == 0) {
+		rollup_add(&app->rollup, &s);
+		server_publish(&app->srv, &s, pipeline_get_mode(&app->pipe));
 	}
+}
+
+static void on_publish(struct watch *w, uint32_t events) {
+	struct app *app = w->ctx;
+
+	(void)events;
+
+	ring_wait(&app->pipe.pub); // epoll이 readable 알려줬으므로 block 안됨
+	publish_pending(app);
+}
+
+/*
+ * 버튼 드라이버는 누를때마다 '0' / '1' 을 번갈아 돌려줌
+ * mode 바뀌면 다음 측정을 기다리지 않고 바로 다시 그림
+ */
+static void on_button(struct watch *w, uint32_t events) {
+	struct app *app = w->ctx;
+	char system_mode;
+
+	(void)events;
+
+	if (read(w->fd, &system_mode, 1) != 1)
+		return; // EAGAIN: 다른 reader가 먼저 가져감
+
+	if (app->rec != NULL)
+		recorder_button(app->rec, system_mode);
+
+	if (system_mode == '0')
+		set_mode(app, SENSORD_MODE_TEMP);
+	else if (system_mode == '1')
+		set_mode(app, SENSORD_MODE_HUMID);
+}
+
+/*
+ * replay 끝: convert가 마지막 측정까지 pub ring에 넣은 뒤 알려줌
+ * 남은 측정을 구독자 / rollup에 넘기고 종료
+ */
+static void on_replay_done(struct watch *w, uint32_t events) {
+	struct app *app = w->ctx;
 
-	fd_lcd = open("/dev/hd44780_device", O_WRONLY);
-	if (fd_lcd < 0) {
-		perror("sht20 open error\n");
+	(void)events;
+
+	publish_pending(app);
+	loop_stop(&app->loop);
+}
+
+static void on_signal(struct watch *w, uint32_t events) {
+	struct app *app = w->ctx;
+	struct signalfd_siginfo si;
+
+	(void)events;
+
+	if (read(w->fd, &si, sizeof(si)) != sizeof(si))
+		return;
+
+	printf("Exiting...\n");
+	loop_stop(&app->loop);
+}
+
+/*
+ * SIGINT/SIGTERM을 fd로 받음
+ * -> 시그널 핸들러에서 하던 정리 작업을 event loop 안에서 안전하게 처리
+ */
+static int make_signalfd(void) {
+	sigset_t mask;
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGINT);
+	sigaddset(&mask, SIGTERM);
+	if (sigprocmask(SIG_BLOCK, &mask, NULL) < 0)
 		return -1;
-	}
 
-	fd_sensor = open("/dev/sht20_device", O_RDONLY);
-	if (fd_sensor < 0) {
-		perror("lcd open error\n");
+	return signalfd(-1, &mask, SFD_CLOEXEC);
+}
+
+/*
+ * 드라이버 초기화가 끝날때까지 대기
+ * probe는 바로 반환하고 LCD/센서 초기화는 커널에서 비동기로 진행
+ * 준비되면 LCD는 writable, 센서는 readable, 실패하면 POLLERR
+ */
+static int wait_ready(int fd, short events, const char *name) {
+	struct pollfd pfd = { .fd = fd, .events = events };
+	int ret = poll(&pfd, 1, READY_TIMEOUT_MS);
+
+	if (ret < 0) {
+		perror("poll error\n");
 		return -1;
 	}
+	if (ret == 0) {
+		fprintf(stderr, "%s not ready\n", name);
+		return -1;
+	}
+	if (pfd.revents & (POLLERR | POLLHUP)) {
+		fprintf(stderr, "%s init failed\n", name);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * render 출력 stub
+ * lcd: /dev/hd44780_device, null: 버림 (처리량 측정), stdout: 측정 시각과 한 줄씩
+ */
+static void draw_lcd_dev(void *ctx, const struct sensord_sample *s, const char *line) {
+	int *fd_lcd = ctx;
+
+	(void)s;
+
+	if (write(*fd_lcd, line, strlen(line)) < 0)
+		perror("lcd write error\n");
+}
+
+static void draw_null(void *ctx, const struct sensord_sample *s, const char *line) {
+	(void)ctx;
+	(void)s;
+	(void)line;
+}
+
+static void draw_stdout(void *ctx, const struct sensord_sample *s, const char *line) {
+	(void)ctx;
 
-	fd_btn = open("/dev/button_device", O_RDONLY);
-	if (fd_btn < 0) {
-		perror("button device open error\n");
+	printf("%lld %s\n", (long long)s->ts_ms, line);
+}
+
+static int64_t monotonic_ms(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void print_replay_stats(struct app *app, int64_t elapsed_ms) {
+	struct pipeline_stats st;
+	char buf[256];
+
+	pipeline_stats(&app->pipe, &st);
+	get_stats(app, buf, sizeof(buf));
+	printf("replay: %lu records, %lu samples in %lld ms (%.0f samples/s)\n",
+	       app->replay.count, st.acquired, (long long)elapsed_ms,
+	       elapsed_ms > 0 ? st.acquired * 1000.0 / elapsed_ms : 0.0);
+	printf("%s\n", buf);
+}
+
+static void usage(const char *prog) {
+	fprintf(stderr,
+		"usage: %s [-d] [-p period_ms] [-s socket_path] [-l log_dir | -n] [-r file]\n"
+		"       %s -R file [-x speed] [-o lcd|null|stdout] [-s socket_path] [-l log_dir]\n"
+		"  -d  daemonize\n"
+		"  -p  sampling period in ms (default %d)\n"
+		"  -s  control socket (default %s, replay: none)\n"
+		"  -l  history log directory (default %s, replay: none)\n"
+		"  -n  no history log\n"
+		"  -r  record sensor and button input to file\n"
+		"  -R  replay recorded file instead of the devices, exit at end\n"
+		"  -x  replay speed: 1 = as recorded (default), N = N times, 0 = max\n"
+		"  -o  display output (default lcd, replay: null)\n",
+		prog, prog, SAMPLE_PERIOD_MS, SENSORD_SOCK_PATH, SENSORD_LOG_DIR);
+}
+
+int main(int argc, char *argv[]) {
+	struct app app = {
+		.period_ms = SAMPLE_PERIOD_MS,
+	};
+	const char *sock_path = NULL;
+	const char *log_dir = SENSORD_LOG_DIR;
+	const char *record_path = NULL;
+	const char *replay_path = NULL;
+	const char *output = NULL;
+	struct pipeline_source src = { .speed = 1 };
+	struct pipeline_sink sink = { .draw = draw_lcd_dev, .ctx = &app.fd_lcd };
+	struct tslog *tslog = NULL;
+	int log_set = 0;
+	int daemonize = 0;
+	int64_t t_start;
+	int opt;
+	int ret;
+
+	while ((opt = getopt(argc, argv, "dp:s:l:nr:R:x:o:h")) != -1) {
+		switch (opt) {
+		case 'd':
+			daemonize = 1;
+			break;
+		case 'p':
+			app.period_ms = atoi(optarg);
+			break;
+		case 's':
+			sock_path = optarg;
+			break;
+		case 'l':
+			log_dir = optarg;
+			log_set = 1;
+			break;
+		case 'n':
+			log_dir = NULL;
+			log_set = 1;
+			break;
+		case 'r':
+			record_path = optarg;
+			break;
+		case 'R':
+			replay_path = optarg;
+			break;
+		case 'x':
+			src.speed = atof(optarg);
+			break;
+		case 'o':
+			output = optarg;
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? 0 : -1;
+		}
+	}
+
+	if (app.period_ms < MIN_PERIOD_MS) {
+		fprintf(stderr, "period must be >= %d ms\n", MIN_PERIOD_MS);
+		return -1;
+	}
+	if (src.speed < 0) {
+		fprintf(stderr, "speed must be >= 0\n");
+		return -1;
+	}
+	if (record_path != NULL && replay_path != NULL) {
+		fprintf(stderr, "-r and -R cannot be used together\n");
 		return -1;
 	}
 
-	pid = fork();
-	if (pid == 0) { // child -> wait of button interrupt
-		shmaddr_c = (char *)shmat(shmid, NULL, 0);
-		*shmaddr_c = '0';
-		char system_mode[1];
+	// replay는 장치 없이 (노트북) 돌리는 경우가 기본 -> 출력, 기록, socket은 지정했을때만
+	if (output == NULL)
+		output = replay_path != NULL ? "null" : "lcd";
+	if (replay_path != NULL && !log_set)
+		log_dir = NULL;
+	if (sock_path == NULL && replay_path == NULL)
+		sock_path = SENSORD_SOCK_PATH;
 
-		while (1) {
-			int len = read(fd_btn, system_mode, 1);
-			if (len < 0) {
-				perror("[CHILD] read error\n");
-			}
+	app.fd_sensor = -1;
+	app.fd_lcd = -1;
+	app.fd_btn_w = -1;
 
-			printf("[CHILD] child : len = %d, system_mode: %c\n", len, system_mode[0]);
-			if (system_mode[0] == '0') {
-				*shmaddr_c = '0';
-			}
-			else if (system_mode[0] == '1') {
-				*shmaddr_c = '1';
-			}
-			usleep(1000000);
+	if (strcmp(output, "null") == 0) {
+		sink = (struct pipeline_sink){ .draw = draw_null };
+	} else if (strcmp(output, "stdout") == 0) {
+		sink = (struct pipeline_sink){ .draw = draw_stdout };
+	} else if (strcmp(output, "lcd") == 0) {
+		app.fd_lcd = open("/dev/hd44780_device", O_WRONLY);
+		if (app.fd_lcd < 0) {
+			perror("lcd open error\n");
+			return -1;
 		}
+	} else {
+		usage(argv[0]);
+		return -1;
 	}
-	else if (pid > 0) { // parent -> read sensor and write LCD
-		shmaddr_p = (char *)shmat(shmid, NULL, 0);
-		*shmaddr_p = '0';
-
-		printf("[PARENT] wait LCD initialize...\n");
-		sleep(5);
-
-		while (is_running) {
-			int len = read(fd_sensor, buf, sizeof(buf) - 1);
-			if (len < 0) {
-				perror("[PARENT] read error\n");
-				return -1;
-			}
-
-			buf[len] = '\0';
-			char *tok = strtok(buf, "|");
-			int humid_raw; // 원본 습도/온도 데이터 (변환 전)
-			int temp_raw;
-
-			if (tok != NULL) {
-				temp_raw = atoi(tok);
-			}
-			tok = strtok(NULL, "|");
-			if (tok != NULL) {
-				humid_raw = atoi(tok);
-			}
-
-			double temp_val = -46.85 + 175.72 * ((double)temp_raw / 65536.0); // 변환
-			double humid_val = -6 + 125 * ((double)humid_raw / 65536.0);
-
-			int temp = temp_val;
-			int humid = humid_val;
-
-			char temp_str[10];
-			char humid_str[10];
-
-			snprintf(temp_str, sizeof(temp_str), "Temp: %d", temp);
-			snprintf(humid_str, sizeof(humid_str), "Humid: %d", humid);
-
-			if (len > 0) {
-				if (*shmaddr_p == '0') {
-					printf("[PARENT] %s\n", temp_str);
-					write(fd_lcd, temp_str, strlen(temp_str));
-				}
-				else if (*shmaddr_p == '1') {
-					printf("[PARENT] %s\n", humid_str);
-					write(fd_lcd, humid_str, strlen(humid_str));
-				}
-			}
-			sleep(1);
+
+	if (replay_path != NULL) {
+		int fds[2];
+
+		if (replay_open(&app.replay, replay_path) < 0)
+			return -1;
+
+		// 재생한 버튼 값은 pipe로 -> 실제 버튼과 같은 on_button
+		if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) < 0) {
+			perror("pipe error\n");
+			return -1;
+		}
+		app.fd_btn = fds[0];
+		app.fd_btn_w = fds[1];
+		src.replay = &app.replay;
+		src.fd_btn = app.fd_btn_w;
+	} else {
+		app.fd_sensor = open("/dev/sht20_device", O_RDONLY);
+		if (app.fd_sensor < 0) {
+			perror("sht20 open error\n");
+			return -1;
 		}
+
+		app.fd_btn = open("/dev/button_device", O_RDONLY | O_NONBLOCK);
+		if (app.fd_btn < 0) {
+			perror("button device open error\n");
+			return -1;
+		}
+		src.fd_sensor = app.fd_sensor;
 	}
-	else {
-		perror("fork error\n");
+
+	if (daemonize && daemon(0, 0) < 0) {
+		perror("daemon error\n");
 		return -1;
 	}
 
-	printf("Cleaning Up\n");
-	close(fd_sensor);
-	close(fd_lcd);
-	close(fd_btn);
+	if ((app.fd_lcd >= 0 && wait_ready(app.fd_lcd, POLLOUT, "lcd") < 0) ||
+	    (app.fd_sensor >= 0 && wait_ready(app.fd_sensor, POLLIN, "sht20") < 0))
+		return -1;
 
-	// 공유 메모리 삭제
-	if (shmctl(shmid, IPC_RMID, NULL) == 0) {
-		printf("shared memory delete\n");
+	// daemon() 뒤에 열어야 상대 경로가 의도한 곳 (daemon은 / 로 chdir)
+	if (record_path != NULL) {
+		if (recorder_open(&app.recorder, record_path) < 0)
+			return -1;
+		app.rec = &app.recorder;
+		src.rec = app.rec;
 	}
-	else {
-		perror("shared memory delete err\n");
+
+	if (loop_init(&app.loop) < 0)
+		return -1;
+
+	// 스레드 만들기 전에 시그널 block -> 모든 스레드가 상속, signalfd로만 받음
+	app.w_signal = (struct watch){ .fd = make_signalfd(), .cb = on_signal, .ctx = &app };
+	if (app.w_signal.fd < 0) {
+		perror("signalfd error\n");
+		return -1;
 	}
-	return 0;
-}
 
-// SIGINT 시그널 발생 시
-void sig_handler(int signo) {
-	if (signo == SIGINT) {
-		printf("Exiting...\n");
+	if (snapshot_open(&app.snap) < 0)
+		return -1;
 
-		if (pid > 0) { // at parent
-			printf("[PARENT] parent kill child process\n");
-			kill(pid, SIGKILL);
-			is_running = 0; // 플래그 종료로 바꿈
-		}
-		else { // at child
-			printf("[CHILD] child process exit...\n");
+	if (rollup_init(&app.rollup) < 0) {
+		fprintf(stderr, "rollup init error\n");
+		snapshot_close(&app.snap);
+		return -1;
+	}
+
+	// 기록 실패해도 모니터링은 계속
+	if (log_dir != NULL) {
+		if (tslog_open(&app.tslog, log_dir, TSLOG_MAX_SEGMENTS) == 0)
+			tslog = &app.tslog;
+		else
+			fprintf(stderr, "history log disabled\n");
+	}
+
+	t_start = monotonic_ms();
+	if (pipeline_start(&app.pipe, &src, &sink, &app.snap, tslog,
+			   SENSORD_MODE_TEMP, app.period_ms) < 0) {
+		rollup_free(&app.rollup);
+		snapshot_close(&app.snap);
+		return -1;
+	}
+
+	app.w_btn = (struct watch){ .fd = app.fd_btn, .cb = on_button, .ctx = &app };
+	app.w_pub = (struct watch){ .fd = app.pipe.pub.efd, .cb = on_publish, .ctx = &app };
+	app.w_done = (struct watch){ .fd = app.pipe.done_efd, .cb = on_replay_done, .ctx = &app };
+	if (loop_add(&app.loop, &app.w_signal, EPOLLIN) < 0 ||
+	    loop_add(&app.loop, &app.w_btn, EPOLLIN) < 0 ||
+	    loop_add(&app.loop, &app.w_pub, EPOLLIN) < 0 ||
+	    loop_add(&app.loop, &app.w_done, EPOLLIN) < 0) {
+		perror("epoll add error\n");
+		ret = -1;
+		goto out;
+	}
+
+	if (sock_path != NULL) {
+		if (server_open(&app.srv, &app.loop, sock_path, &app_server_ops, &app) < 0) {
+			ret = -1;
+			goto out;
 		}
+		server_set_rollup(&app.srv, &app.rollup);
+	}
+
+	ret = loop_run(&app.loop);
+	if (sock_path != NULL)
+		server_close(&app.srv);
+
+out:
+	printf("Cleaning Up\n");
+	pipeline_stop(&app.pipe);
+	if (replay_path != NULL) {
+		print_replay_stats(&app, monotonic_ms() - t_start);
+		replay_close(&app.replay);
+		close(app.fd_btn_w);
 	}
+	if (app.rec != NULL)
+		recorder_close(app.rec);
+	if (tslog != NULL)
+		tslog_close(tslog);
+	snapshot_close(&app.snap);
+	rollup_free(&app.rollup);
+	loop_close(&app.loop);
+	close(app.w_signal.fd);
+	if (app.fd_sensor >= 0)
+		close(app.fd_sensor);
+	if (app.fd_lcd >= 0)
+		close(app.fd_lcd);
+	close(app.fd_btn);
+
+	return ret;
 }
@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+#include "loop.h"
+
+#define MAX_EVENTS 16
+
+int loop_init(struct loop *loop) {
+	loop->running = 0;
+	loop->epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (loop->epfd < 0) {
+		perror("epoll create error\n");
+		return -1;
+	}
+	return 0;
+}
+
+int loop_add(struct loop *loop, struct watch *w, uint32_t events) {
+	struct epoll_event ev = {
+		.events = events,
+		.data.ptr = w,
+	};
+
+	return epoll_ctl(loop->epfd, EPOLL_CTL_ADD, w->fd, &ev);
+}
+
+int loop_mod(struct loop *loop, struct watch *w, uint32_t events) {
+	struct epoll_event ev = {
+		.events = events,
+		.data.ptr = w,
+	};
+
+	return epoll_ctl(loop->epfd, EPOLL_CTL_MOD, w->fd, &ev);
+}
+
+void loop_del(struct loop *loop, struct watch *w) {
+	epoll_ctl(loop->epfd, EPOLL_CTL_DEL, w->fd, NULL);
+}
+
+/*
+ * loop_stop()이 불릴때까지 event 처리
+ * callback 안에서 다른 watch를 loop_del + free 하면 안됨 (같은 epoll_wait 결과에 남아있을 수 있음)
+ * -> 자기 자신만 정리할 것
+ */
+int loop_run(struct loop *loop) {
+	struct epoll_event events[MAX_EVENTS];
+
+	loop->running = 1;
+	while (loop->running) {
+		int n = epoll_wait(loop->epfd, events, MAX_EVENTS, -1);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			perror("epoll_wait error\n");
+			return -1;
+		}
+
+		for (int i = 0; i < n && loop->running; i++) {
+			struct watch *w = events[i].data.ptr;
+			w->cb(w, events[i].events);
+		}
+	}
+	return 0;
+}
+
+void loop_stop(struct loop *loop) {
+	loop->running = 0;
+}
+
+void loop_close(struct loop *loop) {
+	if (loop->epfd >= 0)
+		close(loop->epfd);
+	loop->epfd = -1;
+}
@@ -0,0 +1,32 @@
+#ifndef LOOP_H
+#define LOOP_H
+
+#include <stdint.h>
+
+/*
+ * epoll event loop
+ * fd 하나마다 watch 하나, epoll data.ptr로 watch를 돌려받아 callback 호출
+ */
+struct watch;
+typedef void (*watch_cb)(struct watch *w, uint32_t events);
+
+struct watch {
+	int fd;
+	watch_cb cb;
+	void *ctx;
+};
+
+struct loop {
+	int epfd;
+	int running;
+};
+
+int loop_init(struct loop *loop);
+int loop_add(struct loop *loop, struct watch *w, uint32_t events);
+int loop_mod(struct loop *loop, struct watch *w, uint32_t events);
+void loop_del(struct loop *loop, struct watch *w);
+int loop_run(struct loop *loop);
+void loop_stop(struct loop *loop);
+void loop_close(struct loop *loop);
+
+#endif
@@ -0,0 +1,433 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/timerfd.h>
+
+#include "pipeline.h"
+
+static int64_t realtime_ms(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int64_t monotonic_ns(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int stopping(struct pipeline *p) {
+	return atomic_load_explicit(&p->stop, memory_order_acquire);
+}
+
+/*
+ * 센서 read -> "temp_raw|humid_raw" 파싱
+ * read는 드라이버 안에서 측정이 끝날때까지 block됨
+ */
+static int read_sample(int fd_sensor, struct raw_sample *raw) {
+	char buf[32];
+	int len = read(fd_sensor, buf, sizeof(buf) - 1);
+	if (len <= 0) {
+		perror("sensor read error\n");
+		return -1;
+	}
+
+	buf[len] = '\0';
+	char *save = NULL;
+	char *tok = strtok_r(buf, "|", &save);
+	int humid_raw = 0; // 원본 습도/온도 데이터 (변환 전)
+	int temp_raw = 0;
+
+	if (tok != NULL) {
+		temp_raw = atoi(tok);
+	}
+	tok = strtok_r(NULL, "|", &save);
+	if (tok != NULL) {
+		humid_raw = atoi(tok);
+	}
+
+	raw->ts_ms = realtime_ms();
+	raw->temp_raw = temp_raw;
+	raw->humid_raw = humid_raw;
+	return 0;
+}
+
+static void convert_sample(const struct raw_sample *raw, struct sensord_sample *s) {
+	memset(s, 0, sizeof(*s));
+	s->ts_ms = raw->ts_ms;
+	s->temp_raw = raw->temp_raw;
+	s->humid_raw = raw->humid_raw;
+	s->temp_mc = sensord_temp_mc(raw->temp_raw);
+	s->humid_mpct = sensord_humid_mpct(raw->humid_raw);
+}
+
+/*
+ * 현재 mode에 맞게 측정값을 LCD (또는 stub)에 출력
+ */
+static void draw_lcd(const struct pipeline_sink *sink, const struct sensord_sample *s, int mode) {
+	char str[17]; // LCD 한 줄 16칸
+
+	if (mode == SENSORD_MODE_TEMP)
+		snprintf(str, sizeof(str), "Temp: %d", s->temp_mc / 1000);
+	else
+		snprintf(str, sizeof(str), "Humid: %d", s->humid_mpct / 1000);
+
+	sink->draw(sink->ctx, s, str);
+}
+
+/*
+ * acquire 단계: timerfd tick마다 측정해서 raw ring에 넣기만 함
+ */
+static void *acquire_thread(void *arg) {
+	struct pipeline *p = arg;
+	struct pollfd fds[2] = {
+		{ .fd = p->fd_timer, .events = POLLIN },
+		{ .fd = p->stop_efd, .events = POLLIN },
+	};
+
+	while (!stopping(p)) {
+		struct raw_sample raw;
+		uint64_t expirations;
+
+		if (poll(fds, 2, -1) < 0 || (fds[1].revents & POLLIN))
+			continue; // stop 확인
+
+		if (read(p->fd_timer, &expirations, sizeof(expirations)) != sizeof(expirations))
+			continue;
+		if (expirations > 1)
+			atomic_fetch_add_explicit(&p->overruns, expirations - 1, memory_order_relaxed);
+
+		if (read_sample(p->src.fd_sensor, &raw) < 0) {
+			atomic_fetch_add_explicit(&p->read_errors, 1, memory_order_relaxed);
+			if (p->src.rec != NULL)
+				recorder_read_error(p->src.rec);
+			continue;
+		}
+
+		if (p->src.rec != NULL)
+			recorder_sample(p->src.rec, raw.temp_raw, raw.humid_raw);
+
+		atomic_fetch_add_explicit(&p->acquired, 1, memory_order_relaxed);
+		ring_push(&p->raw, &raw);
+	}
+	return NULL;
+}
+
+/*
+ * deadline (CLOCK_MONOTONIC ns) 까지 대기, stop 되면 -1
+ */
+static int replay_wait(struct pipeline *p, int64_t deadline) {
+	struct pollfd pfd = { .fd = p->stop_efd, .events = POLLIN };
+
+	while (!stopping(p)) {
+		int64_t left = deadline - monotonic_ns();
+		struct timespec ts = { .tv_sec = left / 1000000000LL, .tv_nsec = left % 1000000000LL };
+
+		if (left <= 0)
+			return 0;
+		if (ppoll(&pfd, 1, &ts, NULL) > 0)
+			return -1;
+	}
+	return -1;
+}
+
+/*
+ * acquire 단계 (replay): 기록된 간격 / speed 마다 raw ring에 넣음
+ * 측정 시각은 기록 당시 시각 -> rollup, log 구간이 현장과 같음
+ * 버튼은 pipe로 main loop에 넘김 -> 실제 버튼과 같은 처리 (on_button)
+ */
+static void *replay_thread(void *arg) {
+	struct pipeline *p = arg;
+	struct replay_event ev;
+	int64_t t0 = monotonic_ns();
+	int ret;
+
+	while (!stopping(p) && (ret = replay_next(p->src.replay, &ev)) != 0) {
+		if (ret < 0) {
+			fprintf(stderr, "replay: bad record after %lu records\n", p->src.replay->count);
+			break;
+		}
+
+		if (p->src.speed > 0 && replay_wait(p, t0 + (int64_t)(ev.mono_us * 1000 / p->src.speed)) < 0)
+			break;
+
+		if (ev.type == REPLAY_SAMPLE) {
+			struct raw_sample raw = {
+				.ts_ms = ev.ts_ms,
+				.temp_raw = ev.temp_raw,
+				.humid_raw = ev.humid_raw,
+			};
+			struct timespec backoff = { .tv_nsec = 50000 };
+
+			// 최대 속도: convert가 따라올때까지 기다림 -> 처리량 = convert 속도
+			while (p->src.speed == 0 && ring_full(&p->raw) && !stopping(p))
+				nanosleep(&backoff, NULL);
+
+			atomic_fetch_add_explicit(&p->acquired, 1, memory_order_relaxed);
+			ring_push(&p->raw, &raw);
+		} else if (ev.type == REPLAY_READ_ERROR) {
+			atomic_fetch_add_explicit(&p->read_errors, 1, memory_order_relaxed);
+		} else if (write(p->src.fd_btn, &ev.button, 1) != 1) {
+			perror("replay button write error\n"); // main loop가 pipe를 못 비움
+		}
+	}
+
+	atomic_store_explicit(&p->src_done, 1, memory_order_release);
+	ring_kick(&p->raw);
+	return NULL;
+}
+
+/*
+ * convert 단계: 변환 후 snapshot 게시, render / log / main loop로 전달
+ */
+static void *convert_thread(void *arg) {
+	struct pipeline *p = arg;
+	int done_sent = 0;
+
+	while (!stopping(p)) {
+		struct raw_sample raw;
+		struct sensord_sample s;
+		uint64_t one = 1;
+
+		ring_wait(&p->raw);
+
+		// 비우기 전에 읽음 -> done이면 마지막 측정까지 이번에 꺼냄
+		int src_done = atomic_load_explicit(&p->src_done, memory_order_acquire);
+
+		while (ring_pop(&p->raw, &raw) == 0) {
+			convert_sample(&raw, &s);
+			snapshot_publish(p->snap, &s, pipeline_get_mode(p));
+			ring_push(&p->out, &s);
+			ring_push(&p->pub, &s);
+			if (p->tslog != NULL)
+				ring_push(&p->log, &raw);
+		}
+
+		if (src_done && !done_sent) {
+			done_sent = 1;
+			if (write(p->done_efd, &one, sizeof(one)) < 0)
+				perror("done eventfd write error\n");
+		}
+	}
+	return NULL;
+}
+
+/*
+ * render 단계: 밀린 측정값은 최신 것만 그림
+ * 버튼 등으로 mode가 바뀌면 ring_kick으로 깨워서 마지막 값 다시 그림
+ */
+static void *render_thread(void *arg) {
+	struct pipeline *p = arg;
+	struct sensord_sample last = { 0 };
+	int has_last = 0;
+
+	while (!stopping(p)) {
+		struct sensord_sample s;
+		unsigned long got = 0;
+
+		ring_wait(&p->out);
+		while (ring_pop(&p->out, &s) == 0) {
+			last = s;
+			got++;
+		}
+
+		if (got > 1)
+			atomic_fetch_add_explicit(&p->coalesced, got - 1, memory_order_relaxed);
+		if (got > 0)
+			has_last = 1;
+
+		if (has_last && !stopping(p)) {
+			draw_lcd(&p->sink, &last, pipeline_get_mode(p));
+			atomic_fetch_add_explicit(&p->rendered, 1, memory_order_relaxed);
+		}
+	}
+	return NULL;
+}
+
+/*
+ * log 단계: 압축해서 segment 파일에 append
+ * 파일 I/O가 느려도 다른 단계에는 영향 없음
+ */
+static void *log_thread(void *arg) {
+	struct pipeline *p = arg;
+	struct raw_sample raw;
+
+	while (1) {
+		ring_wait(&p->log);
+		while (ring_pop(&p->log, &raw) == 0) {
+			struct tslog_sample s = {
+				.ts_ms = raw.ts_ms,
+				.temp_raw = raw.temp_raw,
+				.humid_raw = raw.humid_raw,
+			};
+
+			if (tslog_append(p->tslog, &s) == 0)
+				atomic_fetch_add_explicit(&p->logged, 1, memory_order_relaxed);
+		}
+
+		// convert가 끝난 뒤에만 set -> 남은 측정은 다 쓰고 종료
+		if (atomic_load_explicit(&p->log_stop, memory_order_acquire))
+			break;
+	}
+	tslog_sync(p->tslog);
+	return NULL;
+}
+
+int pipeline_set_period(struct pipeline *p, int period_ms) {
+	struct itimerspec its = {
+		.it_value = { .tv_sec = 0, .tv_nsec = 1 }, // 바로 한번 측정
+		.it_interval = {
+			.tv_sec = period_ms / 1000,
+			.tv_nsec = (period_ms % 1000) * 1000000L,
+		},
+	};
+
+	// timerfd_settime은 acquire 스레드가 poll 중이어도 안전
+	return timerfd_settime(p->fd_timer, 0, &its, NULL);
+}
+
+void pipeline_set_mode(struct pipeline *p, int mode) {
+	atomic_store_explicit(&p->mode, mode, memory_order_relaxed);
+	snapshot_set_mode(p->snap, mode);
+	ring_kick(&p->out); // 즉시 다시 그림
+}
+
+int pipeline_get_mode(struct pipeline *p) {
+	return atomic_load_explicit(&p->mode, memory_order_relaxed);
+}
+
+void pipeline_stats(struct pipeline *p, struct pipeline_stats *st) {
+	st->acquired = atomic_load_explicit(&p->acquired, memory_order_relaxed);
+	st->read_errors = atomic_load_explicit(&p->read_errors, memory_order_relaxed);
+	st->overruns = atomic_load_explicit(&p->overruns, memory_order_relaxed);
+	st->rendered = atomic_load_explicit(&p->rendered, memory_order_relaxed);
+	st->coalesced = atomic_load_explicit(&p->coalesced, memory_order_relaxed);
+	st->raw_dropped = ring_dropped(&p->raw);
+	st->out_dropped = ring_dropped(&p->out);
+	st->pub_dropped = ring_dropped(&p->pub);
+	st->logged = atomic_load_explicit(&p->logged, memory_order_relaxed);
+	st->log_dropped = ring_dropped(&p->log);
+}
+
+/*
+ * 스레드 깨우기 (stop 확인하게)
+ */
+static void pipeline_wake(struct pipeline *p) {
+	uint64_t one = 1;
+
+	atomic_store_explicit(&p->stop, 1, memory_order_release);
+	if (write(p->stop_efd, &one, sizeof(one)) < 0)
+		perror("stop eventfd write error\n");
+	ring_kick(&p->raw);
+	ring_kick(&p->out);
+}
+
+// log 스레드는 convert가 끝난 뒤에 멈춤 (남은 기록 다 쓰고)
+static void pipeline_join_log(struct pipeline *p) {
+	if (p->tslog == NULL)
+		return;
+
+	atomic_store_explicit(&p->log_stop, 1, memory_order_release);
+	ring_kick(&p->log);
+	pthread_join(p->th_log, NULL);
+}
+
+// 만들다 실패한 것도 정리 가능 (fd는 -1이면 건너뜀)
+static void pipeline_release(struct pipeline *p) {
+	if (p->fd_timer >= 0)
+		close(p->fd_timer);
+	if (p->stop_efd >= 0)
+		close(p->stop_efd);
+	if (p->done_efd >= 0)
+		close(p->done_efd);
+	ring_destroy(&p->raw);
+	ring_destroy(&p->out);
+	ring_destroy(&p->pub);
+	ring_destroy(&p->log);
+}
+
+/*
+ * 실패하면 그때까지 만든 스레드, fd, ring을 모두 정리하고 -1
+ * (pipeline_stop 부르지 않음)
+ */
+int pipeline_start(struct pipeline *p, const struct pipeline_source *src,
+		   const struct pipeline_sink *sink, struct snapshot *snap,
+		   struct tslog *tslog, int mode, int period_ms) {
+	int started = 0; // render, convert 순서로 만든 개수
+
+	memset(p, 0, sizeof(*p));
+	p->src = *src;
+	p->sink = *sink;
+	p->snap = snap;
+	p->tslog = tslog;
+	atomic_store(&p->mode, mode);
+	p->fd_timer = p->stop_efd = p->done_efd = -1;
+	p->raw.efd = p->out.efd = p->pub.efd = p->log.efd = -1;
+
+	if (ring_init(&p->raw, PIPELINE_RING_SIZE, sizeof(struct raw_sample)) < 0 ||
+	    ring_init(&p->out, PIPELINE_RING_SIZE, sizeof(struct sensord_sample)) < 0 ||
+	    ring_init(&p->pub, PIPELINE_RING_SIZE, sizeof(struct sensord_sample)) < 0 ||
+	    ring_init(&p->log, PIPELINE_LOG_RING_SIZE, sizeof(struct raw_sample)) < 0) {
+		perror("ring init error\n");
+		goto err_release;
+	}
+
+	p->stop_efd = eventfd(0, EFD_CLOEXEC);
+	p->done_efd = eventfd(0, EFD_CLOEXEC);
+	p->fd_timer = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+	if (p->stop_efd < 0 || p->done_efd < 0 || p->fd_timer < 0 ||
+	    (src->replay == NULL && pipeline_set_period(p, period_ms) < 0)) {
+		perror("timerfd/eventfd error\n");
+		goto err_release;
+	}
+
+	if (tslog != NULL && pthread_create(&p->th_log, NULL, log_thread, p) != 0) {
+		p->tslog = NULL; // join할 log 스레드 없음
+		goto err_threads;
+	}
+	if (pthread_create(&p->th_render, NULL, render_thread, p) != 0)
+		goto err_threads;
+	started++;
+	if (pthread_create(&p->th_convert, NULL, convert_thread, p) != 0)
+		goto err_threads;
+	started++;
+	if (pthread_create(&p->th_acquire, NULL,
+			   src->replay != NULL ? replay_thread : acquire_thread, p) != 0)
+		goto err_threads;
+
+	return 0;
+
+err_threads:
+	fprintf(stderr, "pthread create error\n");
+	pipeline_wake(p);
+	if (started > 1)
+		pthread_join(p->th_convert, NULL);
+	if (started > 0)
+		pthread_join(p->th_render, NULL);
+	pipeline_join_log(p);
+err_release:
+	pipeline_release(p);
+	return -1;
+}
+
+/*
+ * 모든 스레드에 stop 알리고 join
+ * acquire가 센서 read 중이면 측정이 끝날때까지 기다림
+ */
+void pipeline_stop(struct pipeline *p) {
+	pipeline_wake(p);
+
+	pthread_join(p->th_acquire, NULL);
+	pthread_join(p->th_convert, NULL);
+	pthread_join(p->th_render, NULL);
+	pipeline_join_log(p);
+
+	pipeline_release(p);
+}
@@ -0,0 +1,116 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "ring.h"
+#include "sensord.h"
+#include "snapshot.h"
+#include "tslog.h"
+#include "replay.h"
+
+#define PIPELINE_RING_SIZE 16
+#define PIPELINE_LOG_RING_SIZE 64 // segment rotate 때 파일 생성이 느릴 수 있음
+
+/*
+ * acquire -> convert -> render 단계, 단계마다 스레드 하나
+ *
+ *   [acquire] --raw--> [convert] --out--> [render]  (LCD write)
+ *                          |
+ *                          +-----pub-----> main event loop (socket 구독자)
+ *                          |
+ *                          +-----log-----> [log]  (tslog, 선택)
+ *
+ * 단계 사이는 SPSC ring -> 느린 LCD write가 다음 측정을 늦추지 않음
+ * ring이 가득 차면 버리고 카운트 (acquire는 절대 block 안됨)
+ *
+ * replay: acquire 입력만 센서 대신 기록 파일 (replay.h), 나머지 단계는 그대로
+ */
+struct raw_sample {
+	int64_t ts_ms;
+	uint16_t temp_raw;
+	uint16_t humid_raw;
+};
+
+/*
+ * acquire 단계 입력
+ * @fd_sensor: timerfd tick마다 read (replay가 NULL일때)
+ * @rec: 센서에서 읽은 값을 기록 (NULL이면 안함)
+ * @replay: 센서 대신 기록 파일, 기록된 간격 / speed 마다 넣음
+ * @speed: 1 = 기록 속도, N = N배, 0 = 최대 (raw ring이 차면 버리지 않고 기다림)
+ * @fd_btn: 재생한 버튼 값을 write (main loop는 버튼 device 대신 이 pipe를 watch)
+ */
+struct pipeline_source {
+	int fd_sensor;
+	struct recorder *rec;
+	struct replay *replay;
+	double speed;
+	int fd_btn;
+};
+
+/*
+ * render 단계 출력 (LCD 한 줄)
+ * 보통은 /dev/hd44780_device write, replay / 처리량 측정에서는 stub (null, stdout)
+ * render 스레드에서 호출
+ */
+struct pipeline_sink {
+	void (*draw)(void *ctx, const struct sensord_sample *s, const char *line);
+	void *ctx;
+};
+
+struct pipeline_stats {
+	unsigned long acquired;
+	unsigned long read_errors;
+	unsigned long overruns; // 측정이 주기보다 오래 걸려서 놓친 tick
+	unsigned long rendered;
+	unsigned long coalesced; // render가 밀려서 최신값만 그리고 건너뛴 측정
+	unsigned long raw_dropped;
+	unsigned long out_dropped;
+	unsigned long pub_dropped;
+	unsigned long logged;
+	unsigned long log_dropped;
+};
+
+struct pipeline {
+	struct pipeline_source src;
+	struct pipeline_sink sink;
+	int fd_timer;
+	int stop_efd;
+	int done_efd; // replay 끝: convert가 마지막 측정까지 넘긴 뒤 readable
+
+	struct snapshot *snap;
+	struct tslog *tslog; // NULL이면 log 단계 없음
+	struct ring raw; // acquire -> convert
+	struct ring out; // convert -> render
+	struct ring pub; // convert -> main loop
+	struct ring log; // convert -> log
+
+	_Atomic int mode;
+	_Atomic int stop;
+	_Atomic int log_stop;
+	_Atomic int src_done; // replay 파일 끝
+
+	_Atomic unsigned long acquired;
+	_Atomic unsigned long read_errors;
+	_Atomic unsigned long overruns;
+	_Atomic unsigned long rendered;
+	_Atomic unsigned long coalesced;
+	_Atomic unsigned long logged;
+
+	pthread_t th_acquire;
+	pthread_t th_convert;
+	pthread_t th_render;
+	pthread_t th_log;
+};
+
+int pipeline_start(struct pipeline *p, const struct pipeline_source *src,
+		   const struct pipeline_sink *sink, struct snapshot *snap,
+		   struct tslog *tslog, int mode, int period_ms);
+int pipeline_set_period(struct pipeline *p, int period_ms);
+void pipeline_set_mode(struct pipeline *p, int mode);
+int pipeline_get_mode(struct pipeline *p);
+void pipeline_stats(struct pipeline *p, struct pipeline_stats *st);
+void pipeline_stop(struct pipeline *p);
+
+#endif
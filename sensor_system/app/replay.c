@@ -0,0 +1,197 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "replay.h"
+
+#define VARINT_MAX 10
+
+static int64_t monotonic_ns(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int64_t realtime_ms(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void put_le(uint8_t *p, uint64_t v, int n) {
+	for (int i = 0; i < n; i++)
+		p[i] = v >> (8 * i);
+}
+
+static uint64_t get_le(const uint8_t *p, int n) {
+	uint64_t v = 0;
+
+	for (int i = 0; i < n; i++)
+		v |= (uint64_t)p[i] << (8 * i);
+	return v;
+}
+
+/*
+ * ---- writer ----
+ */
+int recorder_open(struct recorder *rec, const char *path) {
+	uint8_t hdr[REPLAY_HDR_SIZE] = { 0 };
+
+	memset(rec, 0, sizeof(*rec));
+	rec->fp = fopen(path, "wb");
+	if (rec->fp == NULL) {
+		perror("record file open error\n");
+		return -1;
+	}
+
+	put_le(hdr, REPLAY_MAGIC, 4);
+	put_le(hdr + 4, REPLAY_VERSION, 2);
+	put_le(hdr + 8, realtime_ms(), 8);
+	if (fwrite(hdr, sizeof(hdr), 1, rec->fp) != 1 || fflush(rec->fp) != 0) {
+		perror("record file write error\n");
+		fclose(rec->fp);
+		rec->fp = NULL;
+		return -1;
+	}
+
+	pthread_mutex_init(&rec->lock, NULL);
+	rec->start_ns = monotonic_ns();
+	return 0;
+}
+
+/*
+ * 시각은 lock 안에서 읽음 -> 두 스레드가 써도 파일 안의 간격은 항상 0 이상
+ */
+static void recorder_put(struct recorder *rec, int type, const uint8_t *payload, int len) {
+	uint8_t buf[1 + VARINT_MAX + 4];
+	int n = 0;
+
+	pthread_mutex_lock(&rec->lock);
+
+	int64_t now_us = (monotonic_ns() - rec->start_ns) / 1000;
+	uint64_t delta = now_us - rec->last_us;
+
+	buf[n++] = type;
+	do {
+		buf[n++] = (delta & 0x7f) | (delta > 0x7f ? 0x80 : 0);
+		delta >>= 7;
+	} while (delta != 0);
+	memcpy(buf + n, payload, len);
+	n += len;
+
+	if (fwrite(buf, n, 1, rec->fp) != 1 || fflush(rec->fp) != 0) {
+		perror("record file write error\n");
+	} else {
+		rec->last_us = now_us;
+		rec->count++;
+	}
+
+	pthread_mutex_unlock(&rec->lock);
+}
+
+void recorder_sample(struct recorder *rec, uint16_t temp_raw, uint16_t humid_raw) {
+	uint8_t payload[4];
+
+	put_le(payload, temp_raw, 2);
+	put_le(payload + 2, humid_raw, 2);
+	recorder_put(rec, REPLAY_SAMPLE, payload, sizeof(payload));
+}
+
+void recorder_button(struct recorder *rec, char value) {
+	uint8_t payload = value;
+
+	recorder_put(rec, REPLAY_BUTTON, &payload, 1);
+}
+
+void recorder_read_error(struct recorder *rec) {
+	recorder_put(rec, REPLAY_READ_ERROR, NULL, 0);
+}
+
+void recorder_close(struct recorder *rec) {
+	if (rec->fp == NULL)
+		return;
+
+	fclose(rec->fp);
+	rec->fp = NULL;
+	pthread_mutex_destroy(&rec->lock);
+}
+
+/*
+ * ---- reader ----
+ */
+int replay_open(struct replay *rp, const char *path) {
+	uint8_t hdr[REPLAY_HDR_SIZE];
+
+	memset(rp, 0, sizeof(*rp));
+	rp->fp = fopen(path, "rb");
+	if (rp->fp == NULL) {
+		perror("replay file open error\n");
+		return -1;
+	}
+
+	if (fread(hdr, sizeof(hdr), 1, rp->fp) != 1 ||
+	    get_le(hdr, 4) != REPLAY_MAGIC || get_le(hdr + 4, 2) != REPLAY_VERSION) {
+		fprintf(stderr, "%s: not a sensord record file\n", path);
+		fclose(rp->fp);
+		rp->fp = NULL;
+		return -1;
+	}
+
+	rp->start_ms = (int64_t)get_le(hdr + 8, 8);
+	return 0;
+}
+
+int replay_next(struct replay *rp, struct replay_event *ev) {
+	uint8_t payload[4];
+	uint64_t delta = 0;
+	int c = fgetc(rp->fp);
+
+	if (c == EOF)
+		return 0;
+
+	memset(ev, 0, sizeof(*ev));
+	ev->type = c;
+
+	for (int shift = 0;; shift += 7) {
+		c = fgetc(rp->fp);
+		if (c == EOF || shift >= 7 * VARINT_MAX)
+			return -1;
+
+		delta |= (uint64_t)(c & 0x7f) << shift;
+		if (!(c & 0x80))
+			break;
+	}
+
+	switch (ev->type) {
+	case REPLAY_SAMPLE:
+		if (fread(payload, 4, 1, rp->fp) != 1)
+			return -1;
+		ev->temp_raw = get_le(payload, 2);
+		ev->humid_raw = get_le(payload + 2, 2);
+		break;
+	case REPLAY_BUTTON:
+		if ((c = fgetc(rp->fp)) == EOF)
+			return -1;
+		ev->button = c;
+		break;
+	case REPLAY_READ_ERROR:
+		break;
+	default:
+		return -1;
+	}
+
+	rp->mono_us += delta;
+	rp->count++;
+	ev->mono_us = rp->mono_us;
+	ev->ts_ms = rp->start_ms + rp->mono_us / 1000;
+	return 1;
+}
+
+void replay_close(struct replay *rp) {
+	if (rp->fp != NULL)
+		fclose(rp->fp);
+	rp->fp = NULL;
+}
@@ -0,0 +1,81 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+/*
+ * 입력 기록 / 재생 (sensord -r / -R)
+ *
+ * 센서 원본 tick과 버튼 이벤트를 CLOCK_MONOTONIC 시각과 함께 파일에 기록
+ * -> 재생하면 같은 pipeline (convert, render, pub, log)과 같은 버튼 처리를 그대로 거침
+ *    장치 없이 노트북에서 현장 문제 재현, 최대 속도로 돌려서 pipeline 처리량 측정
+ *
+ * 파일 형식 (little endian)
+ *   header: magic "SRPL", version(u16), reserved(u16), 기록 시작 시각 CLOCK_REALTIME ms (i64)
+ *   record: type(u8) + 이전 record와의 간격 us (LEB128 varint) + payload
+ *     SAMPLE      temp_raw(u16) humid_raw(u16)
+ *     BUTTON      드라이버가 준 값 ('0' / '1')
+ *     READ_ERROR  없음 (센서 read 실패)
+ *   -> 1 Hz 측정이 record당 8 byte
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#define REPLAY_MAGIC 0x4c505253 // "SRPL"
+#define REPLAY_VERSION 1
+#define REPLAY_HDR_SIZE 16
+
+enum replay_type {
+	REPLAY_SAMPLE = 1,
+	REPLAY_BUTTON = 2,
+	REPLAY_READ_ERROR = 3,
+};
+
+struct replay_event {
+	int type;
+	int64_t mono_us; // 기록 시작부터
+	int64_t ts_ms; // 기록 당시 CLOCK_REALTIME (header 시각 + mono_us)
+	uint16_t temp_raw;
+	uint16_t humid_raw;
+	char button;
+};
+
+/*
+ * writer
+ * acquire 스레드 (측정)와 main 스레드 (버튼)가 같이 씀 -> lock
+ * record마다 fflush -> 중간에 죽어도 그때까지는 남음
+ */
+struct recorder {
+	FILE *fp;
+	pthread_mutex_t lock;
+	int64_t start_ns;
+	int64_t last_us;
+	unsigned long count;
+};
+
+int recorder_open(struct recorder *rec, const char *path);
+void recorder_sample(struct recorder *rec, uint16_t temp_raw, uint16_t humid_raw);
+void recorder_button(struct recorder *rec, char value);
+void recorder_read_error(struct recorder *rec);
+void recorder_close(struct recorder *rec);
+
+/*
+ * reader (acquire 스레드 하나만 사용)
+ */
+struct replay {
+	FILE *fp;
+	int64_t start_ms;
+	int64_t mono_us;
+	unsigned long count;
+};
+
+int replay_open(struct replay *rp, const char *path);
+
+/*
+ * 다음 record
+ * 반환: 1 성공, 0 파일 끝, -1 잘못된 record (잘린 파일 포함)
+ */
+int replay_next(struct replay *rp, struct replay_event *ev);
+void replay_close(struct replay *rp);
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef RING_H
+#define RING_H
+
+/*
+ * lock-free single-producer / single-consumer ring
+ *
+ * - producer 스레드 하나만 ring_push, consumer 스레드 하나만 ring_pop 호출
+ * - head는 producer만, tail은 consumer만 씀 -> C11 acquire/release 만으로 충분 (lock 없음)
+ * - 가득 차면 새 항목을 버리고 dropped 증가 -> producer는 절대 block 되지 않음
+ * - consumer를 깨우기 위해 eventfd 사용 (ring_wait는 poll 가능한 fd를 기다림)
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#define RING_CACHELINE 64
+
+struct ring {
+	// producer 쪽
+	_Atomic size_t head __attribute__((aligned(RING_CACHELINE)));
+	_Atomic unsigned long dropped;
+
+	// consumer 쪽 (false sharing 방지용으로 다른 cache line)
+	_Atomic size_t tail __attribute__((aligned(RING_CACHELINE)));
+
+	size_t mask __attribute__((aligned(RING_CACHELINE)));
+	size_t elem_size;
+	unsigned char *buf;
+	int efd; // consumer wakeup
+};
+
+/*
+ * @capacity: 2의 거듭제곱
+ */
+static inline int ring_init(struct ring *r, size_t capacity, size_t elem_size) {
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+		return -1;
+
+	memset(r, 0, sizeof(*r));
+	r->efd = -1; // 실패해도 ring_destroy 가능
+	r->buf = calloc(capacity, elem_size);
+	if (r->buf == NULL)
+		return -1;
+
+	r->efd = eventfd(0, EFD_CLOEXEC);
+	if (r->efd < 0) {
+		free(r->buf);
+		r->buf = NULL;
+		return -1;
+	}
+
+	r->mask = capacity - 1;
+	r->elem_size = elem_size;
+	return 0;
+}
+
+static inline void ring_destroy(struct ring *r) {
+	if (r->efd >= 0)
+		close(r->efd);
+	free(r->buf);
+	r->buf = NULL;
+	r->efd = -1;
+}
+
+/*
+ * consumer 깨우기 (어느 스레드에서 불러도 됨)
+ */
+static inline void ring_kick(struct ring *r) {
+	uint64_t one = 1;
+
+	if (write(r->efd, &one, sizeof(one)) < 0) {
+		// counter overflow일때만 실패 -> 이미 깨울 일이 쌓여있음
+	}
+}
+
+/*
+ * producer 전용
+ * 0: 성공, -1: 가득 참 (dropped 증가)
+ */
+static inline int ring_push(struct ring *r, const void *elem) {
+	size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+	size_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+
+	if (head - tail > r->mask) {
+		atomic_fetch_add_explicit(&r->dropped, 1, memory_order_relaxed);
+		return -1;
+	}
+
+	memcpy(r->buf + (head & r->mask) * r->elem_size, elem, r->elem_size);
+	atomic_store_explicit(&r->head, head + 1, memory_order_release);
+	ring_kick(r);
+	return 0;
+}
+
+/*
+ * producer 전용, 가득 찼는지 (버리지 않고 기다려야 할때: replay 최대 속도)
+ */
+static inline int ring_full(struct ring *r) {
+	size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+	size_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+
+	return head - tail > r->mask;
+}
+
+/*
+ * consumer 전용
+ * 0: 성공, -1: 비어있음
+ */
+static inline int ring_pop(struct ring *r, void *elem) {
+	size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+	size_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+
+	if (tail == head)
+		return -1;
+
+	memcpy(elem, r->buf + (tail & r->mask) * r->elem_size, r->elem_size);
+	atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+	return 0;
+}
+
+/*
+ * consumer 전용, 깨울때까지 block
+ * 깨어난 뒤에는 ring_pop으로 비어있을때까지 꺼낼 것
+ */
+static inline void ring_wait(struct ring *r) {
+	uint64_t cnt;
+
+	if (read(r->efd, &cnt, sizeof(cnt)) < 0) {
+		// EINTR: 호출한 쪽에서 다시 확인
+	}
+}
+
+static inline unsigned long ring_dropped(struct ring *r) {
+	return atomic_load_explicit(&r->dropped, memory_order_relaxed);
+}
+
+#endif
@@ -0,0 +1,135 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "rollup.h"
+
+/*
+ * tier마다 보관 기간
+ * 1s x 3600 = 1시간, 1m x 1440 = 하루, 1h x 720 = 30일
+ */
+static const struct {
+	const char *name;
+	int64_t width_ms;
+	uint32_t capacity;
+} tiers[ROLLUP_TIERS] = {
+	[ROLLUP_1S] = { "1s", 1000, 3600 },
+	[ROLLUP_1M] = { "1m", 60 * 1000, 1440 },
+	[ROLLUP_1H] = { "1h", 60 * 60 * 1000, 720 },
+};
+
+int rollup_init(struct rollup *r) {
+	memset(r, 0, sizeof(*r));
+
+	for (int i = 0; i < ROLLUP_TIERS; i++) {
+		struct rollup_ring *ring = &r->tier[i];
+
+		ring->width_ms = tiers[i].width_ms;
+		ring->capacity = tiers[i].capacity;
+		ring->buckets = calloc(ring->capacity, sizeof(struct rollup_bucket));
+		if (ring->buckets == NULL) {
+			rollup_free(r);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+void rollup_free(struct rollup *r) {
+	for (int i = 0; i < ROLLUP_TIERS; i++) {
+		free(r->tier[i].buckets);
+		r->tier[i].buckets = NULL;
+	}
+}
+
+static void stat_init(struct rollup_stat *st, int32_t v) {
+	st->min = v;
+	st->max = v;
+	st->sum = v;
+}
+
+static void stat_add(struct rollup_stat *st, int32_t v) {
+	if (v < st->min)
+		st->min = v;
+	if (v > st->max)
+		st->max = v;
+	st->sum += v;
+}
+
+static void stat_merge(struct rollup_stat *st, const struct rollup_stat *o) {
+	if (o->min < st->min)
+		st->min = o->min;
+	if (o->max > st->max)
+		st->max = o->max;
+	st->sum += o->sum;
+}
+
+/*
+ * 같은 구간이면 현재 bucket 갱신, 아니면 다음 칸 (가장 오래된 bucket을 덮어씀)
+ * 측정이 없던 구간은 bucket을 만들지 않음
+ */
+static void ring_add(struct rollup_ring *ring, const struct sensord_sample *s) {
+	int64_t start = s->ts_ms - (((s->ts_ms % ring->width_ms) + ring->width_ms) % ring->width_ms);
+	struct rollup_bucket *b = &ring->buckets[ring->head];
+
+	if (ring->used > 0 && b->start_ms == start) {
+		b->count++;
+		stat_add(&b->temp, s->temp_mc);
+		stat_add(&b->humid, s->humid_mpct);
+		return;
+	}
+
+	if (ring->used > 0)
+		ring->head = (ring->head + 1) % ring->capacity;
+	if (ring->used < ring->capacity)
+		ring->used++;
+
+	b = &ring->buckets[ring->head];
+	b->start_ms = start;
+	b->count = 1;
+	stat_init(&b->temp, s->temp_mc);
+	stat_init(&b->humid, s->humid_mpct);
+}
+
+void rollup_add(struct rollup *r, const struct sensord_sample *s) {
+	for (int i = 0; i < ROLLUP_TIERS; i++)
+		ring_add(&r->tier[i], s);
+}
+
+int rollup_tier_parse(const char *name) {
+	for (int i = 0; i < ROLLUP_TIERS; i++) {
+		if (strcmp(name, tiers[i].name) == 0)
+			return i;
+	}
+	return -1;
+}
+
+const char *rollup_tier_name(int tier) {
+	return tiers[tier].name;
+}
+
+const struct rollup_bucket *rollup_get(const struct rollup *r, int tier, uint32_t idx) {
+	const struct rollup_ring *ring = &r->tier[tier];
+
+	if (idx >= ring->used)
+		return NULL;
+
+	return &ring->buckets[(ring->head + ring->capacity - idx) % ring->capacity];
+}
+
+uint32_t rollup_aggregate(const struct rollup *r, int tier, uint32_t n, struct rollup_bucket *out) {
+	const struct rollup_bucket *b;
+	uint32_t i;
+
+	memset(out, 0, sizeof(*out));
+	for (i = 0; i < n && (b = rollup_get(r, tier, i)) != NULL; i++) {
+		if (i == 0) {
+			*out = *b;
+			continue;
+		}
+		out->start_ms = b->start_ms; // 가장 오래된 bucket 시작
+		out->count += b->count;
+		stat_merge(&out->temp, &b->temp);
+		stat_merge(&out->humid, &b->humid);
+	}
+	return i;
+}
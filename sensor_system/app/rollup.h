@@ -0,0 +1,69 @@
+#ifndef ROLLUP_H
+#define ROLLUP_H
+
+/*
+ * 측정값 요약 (min/max/mean) 1초 / 1분 / 1시간 단위
+ *
+ * - 측정값 하나 들어올때 tier마다 현재 bucket만 갱신 -> O(1)
+ * - tier마다 고정 크기 circular buffer -> 가동 시간과 상관없이 메모리 일정
+ * - 긴 구간 검색도 raw 측정값을 다시 볼 필요 없이 bucket 몇 개만 합침
+ *
+ * event loop 스레드에서만 사용 (lock 없음)
+ */
+
+#include <stdint.h>
+
+#include "sensord.h"
+
+enum rollup_tier {
+	ROLLUP_1S,
+	ROLLUP_1M,
+	ROLLUP_1H,
+	ROLLUP_TIERS,
+};
+
+struct rollup_stat {
+	int32_t min;
+	int32_t max;
+	int64_t sum;
+};
+
+struct rollup_bucket {
+	int64_t start_ms; // bucket 시작 시각 (width 단위로 정렬)
+	uint32_t count;
+	struct rollup_stat temp; // m°C
+	struct rollup_stat humid; // 0.001 %RH
+};
+
+struct rollup_ring {
+	int64_t width_ms;
+	uint32_t capacity;
+	uint32_t head; // 현재 bucket 위치
+	uint32_t used;
+	struct rollup_bucket *buckets;
+};
+
+struct rollup {
+	struct rollup_ring tier[ROLLUP_TIERS];
+};
+
+int rollup_init(struct rollup *r);
+void rollup_add(struct rollup *r, const struct sensord_sample *s);
+int rollup_tier_parse(const char *name);
+const char *rollup_tier_name(int tier);
+
+/*
+ * 최근 n개 bucket (최신 것부터 idx 0)
+ * 반환: bucket, 없으면 NULL
+ */
+const struct rollup_bucket *rollup_get(const struct rollup *r, int tier, uint32_t idx);
+
+/*
+ * 최근 n개 bucket을 하나로 합침
+ * 반환: 합친 bucket 개수
+ */
+uint32_t rollup_aggregate(const struct rollup *r, int tier, uint32_t n, struct rollup_bucket *out);
+
+void rollup_free(struct rollup *r);
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef SENSORD_H
+#define SENSORD_H
+
+/*
+ * sensord 공개 인터페이스
+ * 대시보드, 스크립트 등 클라이언트는 이 헤더만 include 하면 됨
+ *
+ * 1. 공유 메모리 snapshot (/dev/shm/sensord)
+ *    - 최신 측정값 하나, seqlock으로 보호
+ *    - 클라이언트는 읽기만 함 -> 센서 버스 비용 0, syscall 0
+ *
+ * 2. Unix domain socket (SENSORD_SOCK_PATH), 한 줄 단위 텍스트 명령
+ *    GET               -> 최신 측정값 한 줄
+ *    SUB / UNSUB       -> 새 측정값마다 한 줄씩 push 받음 / 해제
+ *    MODE temp|humid   -> LCD 표시 모드 변경
+ *    PERIOD <ms>       -> 측정 주기 변경
+ *    STATS             -> 파이프라인 카운터 (측정, 에러, 단계별 drop)
+ *    ROLLUP 1s|1m|1h [n]  -> 최근 n개 구간을 합친 min/max/mean 한 줄
+ *    BUCKETS 1s|1m|1h [n] -> "OK <개수>" 다음에 구간별 min/max/mean (최신부터, 최대 60줄)
+ *    응답: "OK ...", "ERR <reason>", 측정값은 "sample ..." 형식
+ */
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#define SENSORD_SHM_NAME "/sensord"
+#define SENSORD_SOCK_PATH "/run/sensord.sock"
+#define SENSORD_LOG_DIR "/var/lib/sensord" // 측정 기록 (tslog.h)
+#define SENSORD_MAGIC 0x53454e53 // "SENS"
+#define SENSORD_VERSION 1
+
+enum sensord_mode {
+	SENSORD_MODE_TEMP = 0,
+	SENSORD_MODE_HUMID = 1,
+};
+
+/*
+ * 측정값 하나 (고정 소수점)
+ * @ts_ms: 측정 시각, CLOCK_REALTIME ms
+ * @temp_mc: 온도 m°C
+ * @humid_mpct: 습도 0.001 %RH
+ * @temp_raw, @humid_raw: 드라이버가 준 원본 tick
+ */
+struct sensord_sample {
+	int64_t ts_ms;
+	int32_t temp_mc;
+	int32_t humid_mpct;
+	uint16_t temp_raw;
+	uint16_t humid_raw;
+	uint32_t reserved;
+};
+
+/*
+ * raw tick -> 고정 소수점 (double 사용 안함)
+ * T  = -46.85 + 175.72 * raw / 2^16  [°C]
+ * RH = -6 + 125 * raw / 2^16          [%RH]
+ */
+static inline int32_t sensord_temp_mc(uint16_t raw) {
+	return -46850 + (int32_t)((175720LL * raw) >> 16);
+}
+
+static inline int32_t sensord_humid_mpct(uint16_t raw) {
+	return -6000 + (int32_t)((125000LL * raw) >> 16);
+}
+
+/*
+ * 공유 메모리 레이아웃
+ * @seq: 홀수면 writer가 갱신 중
+ * @count: 데몬 시작 후 측정 횟수
+ */
+struct sensord_snapshot {
+	uint32_t magic;
+	uint32_t version;
+	_Atomic uint32_t seq;
+	int32_t mode;
+	uint64_t count;
+	struct sensord_sample sample;
+};
+
+/*
+ * seqlock reader
+ * writer가 중간에 갱신하면 다시 읽음, lock 없이 여러 reader 동시 접근 가능
+ */
+static inline void sensord_snapshot_read(const struct sensord_snapshot *snap,
+					 struct sensord_sample *sample, int32_t *mode, uint64_t *count) {
+	uint32_t s1, s2;
+
+	do {
+		s1 = atomic_load_explicit(&snap->seq, memory_order_acquire);
+		if (s1 & 1)
+			continue; // 갱신 중
+
+		memcpy(sample, (const void *)&snap->sample, sizeof(*sample));
+		if (mode)
+			*mode = snap->mode;
+		if (count)
+			*count = snap->count;
+
+		atomic_thread_fence(memory_order_acquire);
+		s2 = atomic_load_explicit(&snap->seq, memory_order_relaxed);
+	} while ((s1 & 1) || s1 != s2);
+}
+
+#endif
@@ -0,0 +1,345 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+
+#include "server.h"
+
+static const char *mode_name(int mode) {
+	return mode == SENSORD_MODE_HUMID ? "humid" : "temp";
+}
+
+/*
+ * non-blocking 전송
+ * 느린 클라이언트 때문에 데몬이 block 되면 안됨 -> 못 보내면 버리고 카운트
+ * 줄 앞부분만 나간 경우 (short write)는 뒤에 오는 줄이 모두 깨지므로 연결을 끊음
+ * -> 여기서 close 하지 않고 shutdown만, 정리는 그 client의 EPOLLHUP에서
+ */
+static void client_send(struct client *c, const char *buf, size_t len) {
+	ssize_t ret = send(c->w.fd, buf, len, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+	if (ret == (ssize_t)len)
+		return;
+
+	c->dropped++;
+	if (ret > 0)
+		shutdown(c->w.fd, SHUT_RDWR);
+}
+
+static void client_printf(struct client *c, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static void client_printf(struct client *c, const char *fmt, ...) {
+	char buf[SERVER_LINE_MAX];
+	va_list ap;
+	int len;
+
+	va_start(ap, fmt);
+	len = vsnprintf(buf, sizeof(buf), fmt, ap);
+	va_end(ap);
+
+	if (len > 0)
+		client_send(c, buf, len < (int)sizeof(buf) ? (size_t)len : sizeof(buf) - 1);
+}
+
+static int format_sample(char *buf, size_t size, const struct sensord_sample *s, int mode) {
+	return snprintf(buf, size, "sample ts=%lld temp_mc=%d humid_mpct=%d mode=%s\n",
+			(long long)s->ts_ms, s->temp_mc, s->humid_mpct, mode_name(mode));
+}
+
+static int format_bucket(char *buf, size_t size, const char *tag, int tier, uint32_t nbuckets,
+			 const struct rollup_bucket *b) {
+	return snprintf(buf, size,
+			"%s tier=%s buckets=%u start=%lld count=%u "
+			"temp_min=%d temp_max=%d temp_mean=%lld "
+			"humid_min=%d humid_max=%d humid_mean=%lld\n",
+			tag, rollup_tier_name(tier), nbuckets, (long long)b->start_ms, b->count,
+			b->temp.min, b->temp.max, (long long)(b->temp.sum / b->count),
+			b->humid.min, b->humid.max, (long long)(b->humid.sum / b->count));
+}
+
+/*
+ * ROLLUP <1s|1m|1h> [n]  -> 최근 n개 bucket을 합친 한 줄
+ * BUCKETS <1s|1m|1h> [n] -> "OK <개수>" 다음에 bucket 한 줄씩 (최신부터)
+ */
+static void handle_rollup(struct client *c, int per_bucket, char *tier_arg, char *n_arg) {
+	struct server *srv = c->srv;
+	char buf[SERVER_LINE_MAX];
+	int tier;
+	long n;
+
+	if (srv->rollup == NULL) {
+		client_printf(c, "ERR rollups disabled\n");
+		return;
+	}
+
+	tier = tier_arg != NULL ? rollup_tier_parse(tier_arg) : -1;
+	n = n_arg != NULL ? atol(n_arg) : 1;
+	if (tier < 0 || n <= 0) {
+		client_printf(c, "ERR usage: %s 1s|1m|1h [n]\n", per_bucket ? "BUCKETS" : "ROLLUP");
+		return;
+	}
+
+	if (!per_bucket) {
+		struct rollup_bucket agg;
+		uint32_t got = rollup_aggregate(srv->rollup, tier, n, &agg);
+
+		if (got == 0) {
+			client_printf(c, "ERR no sample yet\n");
+			return;
+		}
+		format_bucket(buf, sizeof(buf), "rollup", tier, got, &agg);
+		client_send(c, buf, strlen(buf));
+		return;
+	}
+
+	if (n > SERVER_MAX_BUCKETS)
+		n = SERVER_MAX_BUCKETS;
+
+	uint32_t got = 0;
+	while (got < n && rollup_get(srv->rollup, tier, got) != NULL)
+		got++;
+
+	client_printf(c, "OK %u\n", got);
+	for (uint32_t i = 0; i < got; i++) {
+		format_bucket(buf, sizeof(buf), "bucket", tier, 1, rollup_get(srv->rollup, tier, i));
+		client_send(c, buf, strlen(buf));
+	}
+}
+
+static void client_close(struct client *c) {
+	struct server *srv = c->srv;
+	struct client **pp;
+
+	for (pp = &srv->clients; *pp != NULL; pp = &(*pp)->next) {
+		if (*pp == c) {
+			*pp = c->next;
+			break;
+		}
+	}
+	srv->nclients--;
+
+	loop_del(srv->loop, &c->w);
+	close(c->w.fd);
+	free(c);
+}
+
+static void handle_line(struct client *c, char *line) {
+	struct server *srv = c->srv;
+	char *cmd = strtok(line, " \t\r");
+	char *arg = strtok(NULL, " \t\r");
+
+	if (cmd == NULL)
+		return;
+
+	if (strcmp(cmd, "GET") == 0) {
+		char buf[SERVER_LINE_MAX];
+
+		if (!srv->has_last) {
+			client_printf(c, "ERR no sample yet\n");
+			return;
+		}
+		format_sample(buf, sizeof(buf), &srv->last, srv->mode);
+		client_send(c, buf, strlen(buf));
+	}
+	else if (strcmp(cmd, "SUB") == 0) {
+		c->subscribed = 1;
+		client_printf(c, "OK\n");
+	}
+	else if (strcmp(cmd, "UNSUB") == 0) {
+		c->subscribed = 0;
+		client_printf(c, "OK dropped=%lu\n", c->dropped);
+	}
+	else if (strcmp(cmd, "MODE") == 0) {
+		if (arg != NULL && strcmp(arg, "temp") == 0)
+			srv->ops->set_mode(srv->ctx, SENSORD_MODE_TEMP);
+		else if (arg != NULL && strcmp(arg, "humid") == 0)
+			srv->ops->set_mode(srv->ctx, SENSORD_MODE_HUMID);
+		else {
+			client_printf(c, "ERR usage: MODE temp|humid\n");
+			return;
+		}
+		client_printf(c, "OK\n");
+	}
+	else if (strcmp(cmd, "PERIOD") == 0) {
+		if (arg == NULL || srv->ops->set_period(srv->ctx, atoi(arg)) < 0) {
+			client_printf(c, "ERR usage: PERIOD <ms>\n");
+			return;
+		}
+		client_printf(c, "OK\n");
+	}
+	else if (strcmp(cmd, "ROLLUP") == 0 || strcmp(cmd, "BUCKETS") == 0) {
+		handle_rollup(c, cmd[0] == 'B', arg, strtok(NULL, " \t\r"));
+	}
+	else if (strcmp(cmd, "STATS") == 0) {
+		char buf[SERVER_LINE_MAX - 4];
+
+		srv->ops->stats(srv->ctx, buf, sizeof(buf));
+		client_printf(c, "OK %s\n", buf);
+	}
+	else {
+		client_printf(c, "ERR unknown command\n");
+	}
+}
+
+static void on_client(struct watch *w, uint32_t events) {
+	struct client *c = w->ctx;
+	ssize_t len;
+
+	if (events & (EPOLLHUP | EPOLLERR)) {
+		client_close(c);
+		return;
+	}
+
+	len = read(w->fd, c->in + c->in_len, sizeof(c->in) - c->in_len);
+	if (len <= 0) {
+		if (len < 0 && (errno == EAGAIN || errno == EINTR))
+			return;
+		client_close(c); // EOF
+		return;
+	}
+	c->in_len += len;
+
+	// 완성된 줄 단위로 처리
+	char *start = c->in;
+	char *nl;
+	while ((nl = memchr(start, '\n', c->in + c->in_len - start)) != NULL) {
+		*nl = '\0';
+		handle_line(c, start);
+		start = nl + 1;
+	}
+
+	c->in_len -= start - c->in;
+	memmove(c->in, start, c->in_len);
+
+	if (c->in_len == sizeof(c->in)) { // 줄이 너무 김
+		client_printf(c, "ERR line too long\n");
+		c->in_len = 0;
+	}
+}
+
+static void on_accept(struct watch *w, uint32_t events) {
+	struct server *srv = w->ctx;
+	struct client *c;
+	int fd;
+
+	(void)events;
+
+	fd = accept4(w->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+	if (fd < 0)
+		return;
+
+	if (srv->nclients >= SERVER_MAX_CLIENTS) {
+		close(fd);
+		return;
+	}
+
+	c = calloc(1, sizeof(*c));
+	if (c == NULL) {
+		close(fd);
+		return;
+	}
+
+	c->srv = srv;
+	c->w.fd = fd;
+	c->w.cb = on_client;
+	c->w.ctx = c;
+	if (loop_add(srv->loop, &c->w, EPOLLIN | EPOLLRDHUP) < 0) {
+		close(fd);
+		free(c);
+		return;
+	}
+
+	c->next = srv->clients;
+	srv->clients = c;
+	srv->nclients++;
+}
+
+int server_open(struct server *srv, struct loop *loop, const char *path,
+		const struct server_ops *ops, void *ctx) {
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+	int fd;
+
+	memset(srv, 0, sizeof(*srv));
+	srv->loop = loop;
+	srv->path = path;
+	srv->ops = ops;
+	srv->ctx = ctx;
+
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		fprintf(stderr, "socket path too long\n");
+		return -1;
+	}
+	strcpy(addr.sun_path, path);
+
+	fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		perror("socket error\n");
+		return -1;
+	}
+
+	unlink(path); // 이전 데몬이 남긴 socket 파일
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+		perror("socket bind error\n");
+		close(fd);
+		return -1;
+	}
+	chmod(path, 0666); // 일반 사용자 대시보드도 접속 가능
+
+	srv->listen.fd = fd;
+	srv->listen.cb = on_accept;
+	srv->listen.ctx = srv;
+	if (loop_add(loop, &srv->listen, EPOLLIN) < 0) {
+		perror("epoll add error\n");
+		close(fd);
+		unlink(path);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * 새 측정값을 구독자 모두에게 push
+ * 여기서는 client를 close 하지 않음 (끊긴 client는 자기 EPOLLHUP에서 정리)
+ */
+void server_publish(struct server *srv, const struct sensord_sample *sample, int mode) {
+	char buf[SERVER_LINE_MAX];
+	int len;
+
+	srv->last = *sample;
+	srv->has_last = 1;
+	srv->mode = mode;
+
+	len = format_sample(buf, sizeof(buf), sample, mode);
+	for (struct client *c = srv->clients; c != NULL; c = c->next) {
+		if (c->subscribed)
+			client_send(c, buf, len);
+	}
+}
+
+void server_set_mode(struct server *srv, int mode) {
+	srv->mode = mode;
+}
+
+void server_set_rollup(struct server *srv, const struct rollup *rollup) {
+	srv->rollup = rollup;
+}
+
+void server_close(struct server *srv) {
+	while (srv->clients != NULL)
+		client_close(srv->clients);
+
+	if (srv->listen.fd > 0) {
+		loop_del(srv->loop, &srv->listen);
+		close(srv->listen.fd);
+		unlink(srv->path);
+	}
+	srv->listen.fd = -1;
+}
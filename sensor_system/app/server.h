@@ -0,0 +1,60 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stddef.h>
+
+#include "loop.h"
+#include "sensord.h"
+#include "rollup.h"
+
+#define SERVER_MAX_CLIENTS 32
+#define SERVER_LINE_MAX 256
+#define SERVER_MAX_BUCKETS 60 // BUCKETS 응답 한번에 최대 줄 수 (socket buffer 넘지 않게)
+
+/*
+ * 명령 처리 callback (app.c가 구현)
+ * 0: 성공, -1: 잘못된 인자
+ */
+struct server_ops {
+	void (*set_mode)(void *ctx, int mode);
+	int (*set_period)(void *ctx, int period_ms);
+	int (*stats)(void *ctx, char *buf, size_t size); // "key=value ..." 형식
+};
+
+struct server;
+
+struct client {
+	struct watch w;
+	struct server *srv;
+	char in[SERVER_LINE_MAX];
+	size_t in_len;
+	int subscribed;
+	unsigned long dropped; // socket buffer가 가득차서 버린 줄 수
+	struct client *next;
+};
+
+struct server {
+	struct watch listen;
+	struct loop *loop;
+	const char *path;
+	struct client *clients;
+	int nclients;
+
+	const struct server_ops *ops;
+	void *ctx;
+
+	struct sensord_sample last;
+	int has_last;
+	int mode;
+
+	const struct rollup *rollup; // NULL이면 ROLLUP/BUCKETS 명령 없음
+};
+
+int server_open(struct server *srv, struct loop *loop, const char *path,
+		const struct server_ops *ops, void *ctx);
+void server_publish(struct server *srv, const struct sensord_sample *sample, int mode);
+void server_set_mode(struct server *srv, int mode);
+void server_set_rollup(struct server *srv, const struct rollup *rollup);
+void server_close(struct server *srv);
+
+#endif
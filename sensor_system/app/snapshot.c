@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "snapshot.h"
+
+/*
+ * /dev/shm/sensord 생성 후 mmap
+ * 클라이언트는 O_RDONLY로 열어서 읽기만 함
+ */
+int snapshot_open(struct snapshot *snap) {
+	int fd;
+
+	pthread_mutex_init(&snap->write_lock, NULL);
+
+	fd = shm_open(SENSORD_SHM_NAME, O_CREAT | O_RDWR, 0644);
+	if (fd < 0) {
+		perror("shm_open error\n");
+		return -1;
+	}
+
+	if (ftruncate(fd, sizeof(struct sensord_snapshot)) < 0) {
+		perror("ftruncate error\n");
+		close(fd);
+		return -1;
+	}
+
+	snap->shm = mmap(NULL, sizeof(struct sensord_snapshot), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd); // mapping은 fd 닫아도 유지
+	if (snap->shm == MAP_FAILED) {
+		perror("mmap error\n");
+		snap->shm = NULL;
+		return -1;
+	}
+
+	// 이전 데몬이 남긴 내용은 무시, seq는 짝수로 시작
+	atomic_store_explicit(&snap->shm->seq, 0, memory_order_relaxed);
+	snap->shm->count = 0;
+	snap->shm->mode = SENSORD_MODE_TEMP;
+	memset(&snap->shm->sample, 0, sizeof(snap->shm->sample));
+	snap->shm->version = SENSORD_VERSION;
+	atomic_thread_fence(memory_order_release);
+	snap->shm->magic = SENSORD_MAGIC; // magic이 마지막 -> 클라이언트가 초기화 완료 확인
+
+	return 0;
+}
+
+static void write_begin(struct snapshot *snap) {
+	struct sensord_snapshot *shm = snap->shm;
+	uint32_t seq;
+
+	pthread_mutex_lock(&snap->write_lock);
+	seq = atomic_load_explicit(&shm->seq, memory_order_relaxed);
+
+	atomic_store_explicit(&shm->seq, seq + 1, memory_order_relaxed); // 홀수: 갱신 중
+	atomic_thread_fence(memory_order_release);
+}
+
+static void write_end(struct snapshot *snap) {
+	struct sensord_snapshot *shm = snap->shm;
+	uint32_t seq = atomic_load_explicit(&shm->seq, memory_order_relaxed);
+
+	atomic_store_explicit(&shm->seq, seq + 1, memory_order_release); // 짝수: 완료
+	pthread_mutex_unlock(&snap->write_lock);
+}
+
+void snapshot_publish(struct snapshot *snap, const struct sensord_sample *sample, int mode) {
+	struct sensord_snapshot *shm = snap->shm;
+
+	if (shm == NULL)
+		return;
+
+	write_begin(snap);
+	shm->sample = *sample;
+	shm->mode = mode;
+	shm->count++;
+	write_end(snap);
+}
+
+void snapshot_set_mode(struct snapshot *snap, int mode) {
+	struct sensord_snapshot *shm = snap->shm;
+
+	if (shm == NULL)
+		return;
+
+	write_begin(snap);
+	shm->mode = mode;
+	write_end(snap);
+}
+
+void snapshot_close(struct snapshot *snap) {
+	if (snap->shm == NULL)
+		return;
+
+	munmap(snap->shm, sizeof(struct sensord_snapshot));
+	snap->shm = NULL;
+	shm_unlink(SENSORD_SHM_NAME);
+	pthread_mutex_destroy(&snap->write_lock);
+}
@@ -0,0 +1,23 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <pthread.h>
+
+#include "sensord.h"
+
+/*
+ * sensord 쪽 (writer) 공유 메모리 snapshot
+ * writer가 여러 스레드 (convert 단계, mode 바꾸는 main loop) -> writer끼리는 mutex
+ * reader(클라이언트)는 여전히 lock 없음
+ */
+struct snapshot {
+	struct sensord_snapshot *shm;
+	pthread_mutex_t write_lock;
+};
+
+int snapshot_open(struct snapshot *snap);
+void snapshot_publish(struct snapshot *snap, const struct sensord_sample *sample, int mode);
+void snapshot_set_mode(struct snapshot *snap, int mode);
+void snapshot_close(struct snapshot *snap);
+
+#endif
@@ -0,0 +1,517 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "tslog.h"
+
+#define DATA_BITS ((uint64_t)(TSLOG_SEG_SIZE - TSLOG_HDR_SIZE) * 8)
+#define BLOCK_START_BITS (64 + 16 + 16)
+#define SAMPLE_MAX_BITS (4 + 32 + 2 * (3 + 16))
+
+_Static_assert(sizeof(struct tslog_seg_hdr) <= TSLOG_HDR_SIZE, "segment header too big");
+
+/*
+ * 다른 프로세스(tsquery)가 동시에 읽을 수 있음
+ * -> 데이터 bit를 먼저 쓰고 count/data_bits는 release로 공개
+ */
+#define PUBLISH(field, val) __atomic_store_n(&(field), (val), __ATOMIC_RELEASE)
+#define OBSERVE(field) __atomic_load_n(&(field), __ATOMIC_ACQUIRE)
+
+static int64_t realtime_ms(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/*
+ * ---- bit stream (MSB first) ----
+ */
+static void put_bits(uint8_t *data, uint64_t *pos, uint64_t val, int n) {
+	for (int i = n - 1; i >= 0; i--) {
+		uint8_t mask = 0x80 >> (*pos & 7);
+
+		if ((val >> i) & 1)
+			data[*pos >> 3] |= mask;
+		else
+			data[*pos >> 3] &= ~mask; // 이전에 쓰다 만 bit가 남아있을 수 있음
+		(*pos)++;
+	}
+}
+
+struct bitreader {
+	const uint8_t *data;
+	uint64_t pos;
+	uint64_t end;
+};
+
+/*
+ * byte 단위로 최대 8bit씩 꺼냄
+ * end를 넘으면 0을 돌려주고 pos만 넘김 (호출한 쪽에서 br_overrun으로 확인)
+ */
+static uint64_t get_bits(struct bitreader *br, int n) {
+	uint64_t v = 0;
+
+	if (br->pos + n > br->end) {
+		br->pos += n;
+		return 0;
+	}
+
+	while (n > 0) {
+		int avail = 8 - (br->pos & 7);
+		int take = avail < n ? avail : n;
+		uint8_t byte = br->data[br->pos >> 3];
+
+		v = (v << take) | ((byte >> (avail - take)) & ((1u << take) - 1));
+		br->pos += take;
+		n -= take;
+	}
+	return v;
+}
+
+static int br_overrun(const struct bitreader *br) {
+	return br->pos > br->end;
+}
+
+/*
+ * ---- 시각: delta-of-delta (tick 단위) ----
+ * 0                '0'
+ * [-63, 64]        '10'   + 7bit
+ * [-255, 256]      '110'  + 9bit
+ * [-2047, 2048]    '1110' + 12bit
+ * 나머지           '1111' + 32bit
+ */
+static void put_dod(uint8_t *data, uint64_t *pos, int64_t dod) {
+	if (dod == 0) {
+		put_bits(data, pos, 0, 1);
+	}
+	else if (dod >= -63 && dod <= 64) {
+		put_bits(data, pos, 0x2, 2);
+		put_bits(data, pos, dod + 63, 7);
+	}
+	else if (dod >= -255 && dod <= 256) {
+		put_bits(data, pos, 0x6, 3);
+		put_bits(data, pos, dod + 255, 9);
+	}
+	else if (dod >= -2047 && dod <= 2048) {
+		put_bits(data, pos, 0xE, 4);
+		put_bits(data, pos, dod + 2047, 12);
+	}
+	else {
+		put_bits(data, pos, 0xF, 4);
+		put_bits(data, pos, (uint32_t)(int32_t)dod, 32);
+	}
+}
+
+static int64_t get_dod(struct bitreader *br) {
+	if (get_bits(br, 1) == 0)
+		return 0;
+	if (get_bits(br, 1) == 0)
+		return (int64_t)get_bits(br, 7) - 63;
+	if (get_bits(br, 1) == 0)
+		return (int64_t)get_bits(br, 9) - 255;
+	if (get_bits(br, 1) == 0)
+		return (int64_t)get_bits(br, 12) - 2047;
+	return (int32_t)(uint32_t)get_bits(br, 32);
+}
+
+/*
+ * ---- 값: 이전 값과의 delta, zigzag ----
+ * raw tick의 하위 2bit는 status bit(드라이버가 0으로 만듦) -> 14bit만 저장
+ * 0            '0'
+ * z in 1..8    '10'  + 3bit
+ * z in 1..64   '110' + 6bit
+ * 나머지       '111' + 16bit
+ */
+static void put_delta(uint8_t *data, uint64_t *pos, int32_t d) {
+	uint32_t z = ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+
+	if (d == 0) {
+		put_bits(data, pos, 0, 1);
+	}
+	else if (z <= 8) {
+		put_bits(data, pos, 0x2, 2);
+		put_bits(data, pos, z - 1, 3);
+	}
+	else if (z <= 64) {
+		put_bits(data, pos, 0x6, 3);
+		put_bits(data, pos, z - 1, 6);
+	}
+	else {
+		put_bits(data, pos, 0x7, 3);
+		put_bits(data, pos, z, 16);
+	}
+}
+
+static int32_t get_delta(struct bitreader *br) {
+	uint32_t z;
+
+	if (get_bits(br, 1) == 0)
+		return 0;
+	if (get_bits(br, 1) == 0)
+		z = get_bits(br, 3) + 1;
+	else if (get_bits(br, 1) == 0)
+		z = get_bits(br, 6) + 1;
+	else
+		z = get_bits(br, 16);
+
+	return (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+}
+
+/*
+ * ---- segment 파일 ----
+ */
+static int is_segment(const struct dirent *d) {
+	size_t len = strlen(d->d_name);
+
+	return strncmp(d->d_name, "seg-", 4) == 0 && len > 8 && strcmp(d->d_name + len - 4, ".tsl") == 0;
+}
+
+/*
+ * 이름이 시각 hex라서 알파벳 순 = 시간 순
+ */
+static int list_segments(const char *dir, struct dirent ***list) {
+	return scandir(dir, list, is_segment, alphasort);
+}
+
+static void free_list(struct dirent **list, int n) {
+	for (int i = 0; i < n; i++)
+		free(list[i]);
+	free(list);
+}
+
+static struct tslog_seg_hdr *map_segment(const char *path, int writable) {
+	struct tslog_seg_hdr *hdr;
+	struct stat st;
+	int fd;
+
+	fd = open(path, writable ? O_RDWR : O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	if (fstat(fd, &st) < 0 || st.st_size != TSLOG_SEG_SIZE) {
+		close(fd);
+		return NULL;
+	}
+
+	hdr = mmap(NULL, TSLOG_SEG_SIZE, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (hdr == MAP_FAILED)
+		return NULL;
+
+	if (hdr->magic != TSLOG_MAGIC || hdr->version != TSLOG_VERSION ||
+	    hdr->seg_size != TSLOG_SEG_SIZE || hdr->tick_ms != TSLOG_TICK_MS ||
+	    hdr->nblocks > TSLOG_MAX_BLOCKS || hdr->data_bits > DATA_BITS) {
+		munmap(hdr, TSLOG_SEG_SIZE);
+		return NULL;
+	}
+	return hdr;
+}
+
+static void unmap_current(struct tslog *log) {
+	if (log->hdr == NULL)
+		return;
+
+	msync(log->hdr, TSLOG_SEG_SIZE, MS_SYNC);
+	munmap(log->hdr, TSLOG_SEG_SIZE);
+	log->hdr = NULL;
+	log->data = NULL;
+}
+
+/*
+ * 가장 오래된 segment부터 지워서 keep개만 남김
+ */
+static void enforce_retention(struct tslog *log, int keep) {
+	struct dirent **list;
+	char path[sizeof(log->dir) + 300];
+	int n = list_segments(log->dir, &list);
+
+	if (n < 0)
+		return;
+
+	for (int i = 0; i < n - keep; i++) {
+		snprintf(path, sizeof(path), "%s/%s", log->dir, list[i]->d_name);
+		unlink(path);
+	}
+	free_list(list, n);
+}
+
+/*
+ * 새 segment 파일 생성 (sparse, 쓴 page만 실제 공간 차지)
+ */
+static int new_segment(struct tslog *log, int64_t first_ts) {
+	char path[sizeof(log->dir) + 32];
+	int fd = -1;
+
+	unmap_current(log);
+	enforce_retention(log, log->max_segments - 1);
+
+	for (int64_t name = first_ts; fd < 0; name++) { // 같은 ms에 두번 rotate되면 이름 겹침
+		snprintf(path, sizeof(path), "%s/seg-%016llx.tsl", log->dir, (unsigned long long)name);
+		fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+		if (fd < 0 && errno != EEXIST) {
+			perror("tslog segment create error\n");
+			return -1;
+		}
+	}
+
+	if (ftruncate(fd, TSLOG_SEG_SIZE) < 0) {
+		perror("tslog ftruncate error\n");
+		close(fd);
+		unlink(path);
+		return -1;
+	}
+
+	log->hdr = mmap(NULL, TSLOG_SEG_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (log->hdr == MAP_FAILED) {
+		perror("tslog mmap error\n");
+		log->hdr = NULL;
+		unlink(path);
+		return -1;
+	}
+
+	log->data = (uint8_t *)log->hdr + TSLOG_HDR_SIZE;
+	log->hdr->version = TSLOG_VERSION;
+	log->hdr->tick_ms = TSLOG_TICK_MS;
+	log->hdr->seg_size = TSLOG_SEG_SIZE;
+	log->hdr->first_ts = first_ts;
+	log->hdr->last_ts = first_ts;
+	PUBLISH(log->hdr->magic, TSLOG_MAGIC);
+	return 0;
+}
+
+/*
+ * 디렉토리의 마지막 segment에 이어서 기록 (새 block부터 시작 -> encoder 상태 복구 필요 없음)
+ * segment가 없거나 깨졌으면 첫 append 때 새로 만듦
+ */
+int tslog_open(struct tslog *log, const char *dir, int max_segments) {
+	struct dirent **list;
+	int n;
+
+	memset(log, 0, sizeof(*log));
+	if (strlen(dir) >= sizeof(log->dir)) {
+		fprintf(stderr, "tslog dir too long\n");
+		return -1;
+	}
+	strcpy(log->dir, dir);
+	log->max_segments = max_segments > 1 ? max_segments : 1;
+	log->last_sync_ms = realtime_ms();
+
+	if (mkdir(dir, 0755) < 0 && errno != EEXIST) {
+		perror("tslog mkdir error\n");
+		return -1;
+	}
+
+	n = list_segments(dir, &list);
+	if (n < 0) {
+		perror("tslog scandir error\n");
+		return -1;
+	}
+
+	if (n > 0) {
+		char path[sizeof(log->dir) + 300];
+
+		snprintf(path, sizeof(path), "%s/%s", dir, list[n - 1]->d_name);
+		log->hdr = map_segment(path, 1);
+		if (log->hdr != NULL)
+			log->data = (uint8_t *)log->hdr + TSLOG_HDR_SIZE;
+	}
+	log->need_block = 1;
+	free_list(list, n);
+
+	return 0;
+}
+
+/*
+ * 측정값 하나 추가
+ * block 첫 측정은 전체 값, 이후는 delta-of-delta / delta
+ */
+int tslog_append(struct tslog *log, const struct tslog_sample *s) {
+	struct tslog_seg_hdr *hdr = log->hdr;
+	int64_t tick = s->ts_ms / TSLOG_TICK_MS;
+	int temp = s->temp_raw >> 2;
+	int humid = s->humid_raw >> 2;
+	int new_block = 0;
+	int64_t delta = 0;
+	int64_t dod = 0;
+	uint64_t pos;
+
+	if (hdr == NULL || log->need_block || hdr->nblocks == 0 ||
+	    hdr->index[hdr->nblocks - 1].count >= TSLOG_BLOCK_SAMPLES) {
+		new_block = 1;
+	}
+	else {
+		delta = tick - log->prev_tick;
+		dod = delta - log->prev_delta;
+		if (dod < INT32_MIN || dod > INT32_MAX) // 시계가 크게 바뀜
+			new_block = 1;
+	}
+
+	// 이번 측정이 들어갈 자리가 없으면 rotate
+	if (hdr != NULL && !new_block && hdr->data_bits + SAMPLE_MAX_BITS > DATA_BITS)
+		new_block = 1;
+	if (hdr == NULL || (new_block && (hdr->nblocks >= TSLOG_MAX_BLOCKS ||
+					  hdr->data_bits + BLOCK_START_BITS > DATA_BITS))) {
+		if (new_segment(log, s->ts_ms) < 0)
+			return -1;
+		hdr = log->hdr;
+		new_block = 1;
+	}
+
+	pos = hdr->data_bits;
+	if (new_block) {
+		struct tslog_index *idx = &hdr->index[hdr->nblocks];
+
+		put_bits(log->data, &pos, (uint64_t)tick, 64);
+		put_bits(log->data, &pos, temp, 16);
+		put_bits(log->data, &pos, humid, 16);
+
+		idx->first_ts = s->ts_ms;
+		idx->bit_off = hdr->data_bits;
+		idx->count = 1;
+		PUBLISH(hdr->nblocks, hdr->nblocks + 1);
+		log->prev_delta = 0;
+		log->need_block = 0;
+	}
+	else {
+		struct tslog_index *idx = &hdr->index[hdr->nblocks - 1];
+
+		put_dod(log->data, &pos, dod);
+		put_delta(log->data, &pos, temp - log->prev_temp);
+		put_delta(log->data, &pos, humid - log->prev_humid);
+
+		PUBLISH(idx->count, idx->count + 1);
+		log->prev_delta = delta;
+	}
+
+	log->prev_tick = tick;
+	log->prev_temp = temp;
+	log->prev_humid = humid;
+
+	if (hdr->count == 0)
+		hdr->first_ts = s->ts_ms;
+	hdr->last_ts = s->ts_ms;
+	PUBLISH(hdr->count, hdr->count + 1);
+	PUBLISH(hdr->data_bits, pos);
+
+	if (s->ts_ms - log->last_sync_ms >= TSLOG_SYNC_SEC * 1000LL)
+		tslog_sync(log);
+
+	return 0;
+}
+
+/*
+ * 쌓인 dirty page를 한번에 flash로
+ */
+void tslog_sync(struct tslog *log) {
+	if (log->hdr != NULL)
+		msync(log->hdr, TSLOG_SEG_SIZE, MS_ASYNC);
+	log->last_sync_ms = realtime_ms();
+}
+
+void tslog_close(struct tslog *log) {
+	unmap_current(log);
+}
+
+/*
+ * ---- 검색 ----
+ */
+static long query_block(const struct tslog_seg_hdr *hdr, const struct tslog_index *idx, uint32_t count,
+			int64_t from_ms, int64_t to_ms, tslog_cb cb, void *ctx, int *stop) {
+	struct bitreader br = {
+		.data = (const uint8_t *)hdr + TSLOG_HDR_SIZE,
+		.pos = idx->bit_off,
+		.end = OBSERVE(hdr->data_bits),
+	};
+	struct tslog_sample s;
+	int64_t tick, delta = 0;
+	int temp, humid;
+	long n = 0;
+
+	tick = (int64_t)get_bits(&br, 64);
+	temp = get_bits(&br, 16);
+	humid = get_bits(&br, 16);
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (i > 0) {
+			delta += get_dod(&br);
+			tick += delta;
+			temp += get_delta(&br);
+			humid += get_delta(&br);
+		}
+		if (br_overrun(&br))
+			break;
+
+		// block 첫 측정은 index에 ms 단위 시각이 있음
+		s.ts_ms = i == 0 ? idx->first_ts : tick * TSLOG_TICK_MS;
+		if (s.ts_ms < from_ms || s.ts_ms > to_ms)
+			continue;
+
+		s.temp_raw = temp << 2;
+		s.humid_raw = humid << 2;
+		n++;
+		if (cb(&s, ctx) != 0) {
+			*stop = 1;
+			break;
+		}
+	}
+	return n;
+}
+
+static long query_segment(const struct tslog_seg_hdr *hdr, int64_t from_ms, int64_t to_ms,
+			  tslog_cb cb, void *ctx, int *stop) {
+	uint32_t nblocks = OBSERVE(hdr->nblocks);
+	long n = 0;
+
+	if (OBSERVE(hdr->count) == 0 || hdr->last_ts < from_ms || hdr->first_ts > to_ms)
+		return 0; // segment 통째로 건너뜀
+
+	for (uint32_t i = 0; i < nblocks && !*stop; i++) {
+		const struct tslog_index *idx = &hdr->index[i];
+		uint32_t count = OBSERVE(idx->count);
+
+		// index만 보고 범위 밖 block은 decode 안함
+		if (idx->first_ts > to_ms)
+			continue;
+		if (i + 1 < nblocks && hdr->index[i + 1].first_ts <= from_ms)
+			continue;
+
+		n += query_block(hdr, idx, count, from_ms, to_ms, cb, ctx, stop);
+	}
+	return n;
+}
+
+long tslog_query(const char *dir, int64_t from_ms, int64_t to_ms, tslog_cb cb, void *ctx) {
+	struct dirent **list;
+	char path[512];
+	int stop = 0;
+	long total = 0;
+	int n;
+
+	n = list_segments(dir, &list);
+	if (n < 0)
+		return -1;
+
+	for (int i = 0; i < n && !stop; i++) {
+		struct tslog_seg_hdr *hdr;
+
+		snprintf(path, sizeof(path), "%s/%s", dir, list[i]->d_name);
+		hdr = map_segment(path, 0);
+		if (hdr == NULL)
+			continue; // 깨졌거나 다른 버전
+
+		total += query_segment(hdr, from_ms, to_ms, cb, ctx, &stop);
+		munmap(hdr, TSLOG_SEG_SIZE);
+	}
+	free_list(list, n);
+
+	return total;
+}
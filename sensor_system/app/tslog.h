@@ -0,0 +1,97 @@
+#ifndef TSLOG_H
+#define TSLOG_H
+
+/*
+ * 측정 기록 (time-series log)
+ *
+ * - 디렉토리 안에 고정 크기 segment 파일 (seg-<첫 측정 시각 hex>.tsl), mmap 해서 append
+ * - segment가 가득 차면 새 segment, TSLOG_MAX_SEGMENTS 넘으면 가장 오래된 것 삭제
+ * - Gorilla 방식 압축
+ *     시각: delta-of-delta (주기가 일정하면 1bit)
+ *     온도/습도: 이전 값과의 delta (변화 없으면 1bit)
+ *   -> 1 Hz 측정이 1.5 byte 정도, 한달 수 MB
+ * - TSLOG_BLOCK_SAMPLES 마다 block 시작 (전체 값 저장), segment header에 block index
+ *   -> 범위 검색 시 필요한 block만 decode
+ * - 저장은 page cache에만 하고 msync는 TSLOG_SYNC_SEC 마다 -> SD카드 쓰기 횟수 줄임
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define TSLOG_MAGIC 0x474c5354 // "TSLG"
+#define TSLOG_VERSION 1
+#define TSLOG_SEG_SIZE (256 * 1024)
+#define TSLOG_HDR_SIZE 4096
+#define TSLOG_TICK_MS 10 // 시각 저장 단위
+#define TSLOG_BLOCK_SAMPLES 1024
+#define TSLOG_MAX_SEGMENTS 128
+#define TSLOG_SYNC_SEC 300
+
+struct tslog_sample {
+	int64_t ts_ms;
+	uint16_t temp_raw;
+	uint16_t humid_raw;
+};
+
+/*
+ * segment 파일 안의 block 하나
+ * @first_ts: block 첫 측정 시각 (ms)
+ * @bit_off: data 영역 안에서의 시작 bit 위치
+ * @count: block 안의 측정 개수
+ */
+struct tslog_index {
+	int64_t first_ts;
+	uint32_t bit_off;
+	uint32_t count;
+};
+
+#define TSLOG_HDR_FIXED 64
+#define TSLOG_MAX_BLOCKS ((TSLOG_HDR_SIZE - TSLOG_HDR_FIXED) / sizeof(struct tslog_index))
+
+struct tslog_seg_hdr {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t tick_ms;
+	uint32_t seg_size;
+	uint32_t nblocks;
+	uint64_t data_bits; // 여기까지 완전히 기록됨
+	uint64_t count;
+	int64_t first_ts;
+	int64_t last_ts;
+	uint8_t reserved[TSLOG_HDR_FIXED - 48];
+	struct tslog_index index[TSLOG_MAX_BLOCKS];
+};
+
+/*
+ * writer (sensord의 log 단계 스레드 하나만 사용)
+ */
+struct tslog {
+	char dir[200];
+	int max_segments;
+	struct tslog_seg_hdr *hdr; // 현재 segment mmap (NULL이면 아직 없음)
+	uint8_t *data;
+
+	// 현재 block의 encoder 상태
+	int need_block; // 다시 열었을때는 상태를 모르므로 새 block부터
+	int64_t prev_tick;
+	int64_t prev_delta;
+	int prev_temp;
+	int prev_humid;
+
+	int64_t last_sync_ms;
+};
+
+int tslog_open(struct tslog *log, const char *dir, int max_segments);
+int tslog_append(struct tslog *log, const struct tslog_sample *s);
+void tslog_sync(struct tslog *log);
+void tslog_close(struct tslog *log);
+
+/*
+ * reader
+ * [from_ms, to_ms] 범위 측정값마다 cb 호출, cb가 0이 아닌 값 돌려주면 중단
+ * 반환: 전달한 측정 개수, -1: 에러
+ */
+typedef int (*tslog_cb)(const struct tslog_sample *s, void *ctx);
+long tslog_query(const char *dir, int64_t from_ms, int64_t to_ms, tslog_cb cb, void *ctx);
+
+#endif
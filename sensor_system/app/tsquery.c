@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sensord.h"
+#include "tslog.h"
+
+/*
+ * tsquery: sensord 측정 기록 검색
+ * 시각은 epoch 초, 음수면 지금부터 몇 초 전 (ex: -f -3600 -> 최근 1시간)
+ * 출력: CSV (ts_ms,temp_c,humid_pct)
+ */
+
+struct query {
+	int count_only;
+	long n;
+	int64_t first_ts;
+	int64_t last_ts;
+};
+
+static int64_t parse_time(const char *str) {
+	long long sec = atoll(str);
+
+	if (sec < 0)
+		return (int64_t)(time(NULL) + sec) * 1000;
+	return (int64_t)sec * 1000;
+}
+
+static int print_sample(const struct tslog_sample *s, void *ctx) {
+	struct query *q = ctx;
+	int32_t temp = sensord_temp_mc(s->temp_raw);
+	int32_t humid = sensord_humid_mpct(s->humid_raw);
+
+	if (q->n == 0)
+		q->first_ts = s->ts_ms;
+	q->last_ts = s->ts_ms;
+	q->n++;
+
+	if (!q->count_only)
+		printf("%lld,%s%d.%02d,%s%d.%02d\n", (long long)s->ts_ms,
+		       temp < 0 ? "-" : "", abs(temp) / 1000, (abs(temp) % 1000) / 10,
+		       humid < 0 ? "-" : "", abs(humid) / 1000, (abs(humid) % 1000) / 10);
+	return 0;
+}
+
+static void usage(const char *prog) {
+	fprintf(stderr,
+		"usage: %s [-d log_dir] [-f from] [-t to] [-c]\n"
+		"  -d  history log directory (default %s)\n"
+		"  -f  start, epoch seconds or -N for N seconds ago (default: all)\n"
+		"  -t  end, epoch seconds or -N for N seconds ago (default: now)\n"
+		"  -c  print count and time span only\n",
+		prog, SENSORD_LOG_DIR);
+}
+
+int main(int argc, char *argv[]) {
+	const char *dir = SENSORD_LOG_DIR;
+	int64_t from_ms = INT64_MIN;
+	int64_t to_ms = INT64_MAX;
+	struct query q = { 0 };
+	int opt;
+	long n;
+
+	while ((opt = getopt(argc, argv, "d:f:t:ch")) != -1) {
+		switch (opt) {
+		case 'd':
+			dir = optarg;
+			break;
+		case 'f':
+			from_ms = parse_time(optarg);
+			break;
+		case 't':
+			to_ms = parse_time(optarg);
+			break;
+		case 'c':
+			q.count_only = 1;
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? 0 : -1;
+		}
+	}
+
+	if (!q.count_only)
+		printf("ts_ms,temp_c,humid_pct\n");
+
+	n = tslog_query(dir, from_ms, to_ms, print_sample, &q);
+	if (n < 0) {
+		perror("tslog query error\n");
+		return -1;
+	}
+
+	if (q.count_only) {
+		printf("samples=%ld", n);
+		if (n > 0)
+			printf(" first_ts=%lld last_ts=%lld", (long long)q.first_ts, (long long)q.last_ts);
+		printf("\n");
+	}
+	return 0;
+}
@@ -0,0 +1,45 @@
+/*
+ * 버튼 IRQ tracepoints
+ * /sys/kernel/tracing/events/button/
+ * btn_irq -> btn_wakeup 간격 = IRQ에서 reader가 깨어나기까지 지연
+ */
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM button
+
+#if !defined(_BTN_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _BTN_TRACE_H
+
+#include <linux/tracepoint.h>
+
+TRACE_EVENT(btn_irq,
+	TP_PROTO(int irq),
+	TP_ARGS(irq),
+	TP_STRUCT__entry(
+		__field(int, irq)
+	),
+	TP_fast_assign(
+		__entry->irq = irq;
+	),
+	TP_printk("irq=%d", __entry->irq)
+);
+
+/* reader가 깨어나서 값을 가져감 */
+TRACE_EVENT(btn_wakeup,
+	TP_PROTO(char msg),
+	TP_ARGS(msg),
+	TP_STRUCT__entry(
+		__field(char, msg)
+	),
+	TP_fast_assign(
+		__entry->msg = msg;
+	),
+	TP_printk("msg=%c", __entry->msg)
+);
+
+#endif /* _BTN_TRACE_H */
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE btn_trace
+#include <trace/define_trace.h>
@@ -8,6 +8,23 @@
 #include <linux/gpio.h>
 #include <linux/cdev.h>
 #include <linux/string.h>
+#include <linux/uaccess.h>
+#include <linux/workqueue.h>
+#include <linux/wait.h>
+#include <linux/poll.h>
+#include <linux/ktime.h>
+#include <linux/mutex.h>
+#include <linux/list.h>
+#include <linux/kref.h>
+#include <linux/completion.h>
+
+#include "jmw_stats.h"
+#include "jmw_i2c_sched.h"
+#include "jmw_export.h"
+#include "hd44780_encode.h"
+
+#define CREATE_TRACE_POINTS
+#include "hd44780_trace.h"
 
 #define DRIVER_NAME "hd44780_driver"
 #define DEVICE_COUNT 1
@@ -64,41 +81,79 @@
  * 	처음 전원 공급하면 다음과 같은 상태가 됨.
  */
 
-/*
- *
- * BL|E|RW|RS -> 하위 4비트에 들어감
- * 1 |1|0 |1
- *
- */
-#define RS (1 << 0)
-#define RW (0 << 1) // write만 할거임
-#define E (1 << 2) // 펄스
-#define BL (1 << 3) // 백라이트
-
 #define LCD_CLEARDISPLAY 0x01
 #define LCD_RETURNHOME 0x02
 #define LCD_FUNCTIONSET 0x28
 #define LCD_DISPLAYON 0x0C
 #define LCD_DISPLAYOFF 0x08
 #define LCD_ENTRYMODESET 0x06
+#define LCD_SETDDRAMADDR 0x80
+#define LCD_LINE2 0x40 // 2번째 줄 DDRAM 시작 주소
+
+#define LCD_COLS 16 // 한 줄 16칸
+
+/*
+ * 초기화 상태
+ * probe는 char device만 만들고 바로 반환, LCD 초기화는 init_work에서
+ * 유저는 poll(POLLOUT)로 준비 완료를 기다림
+ */
+enum hd44780_state {
+	HD44780_INIT,
+	HD44780_READY,
+	HD44780_FAILED,
+};
 
 static struct hd44780_device {
 	struct i2c_client *client;
 	dev_t dev_num;
 	struct cdev hd44780_cdev;
 	struct class *class;
+
+	struct work_struct init_work;
+	enum hd44780_state state;
+	wait_queue_head_t wq; // 초기화 끝나길 기다리는 write / poll
+	struct mutex lock; // clear + 16칸 출력 (니블 ~100개)을 한 writer가 끝까지
+
+	struct jmw_stats stats; // PCF8574 바이트 단위, debugfs hd44780:<i2c dev>
+	struct jmw_i2c_sched *sched; // 같은 adapter의 SHT20과 공유, LCD는 DISPLAY 우선순위
+	struct list_head node; // hd44780_list (hd44780_print_lines에서 이름으로 찾음)
+	struct kref ref; // 목록 1 + 출력 중인 hd44780_print_lines 마다 1 + 열린 파일마다 1
+	struct completion released; // ref가 0 -> remove 진행
 };
 
+/*
+ * hd44780_print_lines()용 인스턴스 목록
+ * lock은 찾고 ref 잡는 동안만 -> 다른 LCD 출력이나 remove를 막지 않음
+ * remove는 목록에서 빼고 자기 ref를 놓은 뒤 출력 중인 호출이 다 끝날때까지 기다림
+ */
+static LIST_HEAD(hd44780_list);
+static DEFINE_MUTEX(hd44780_list_lock);
+
 static const struct of_device_id hd44780_ids[] = {
 	{.compatible = "jmw,hd44780"},
 	{},
 };
 MODULE_DEVICE_TABLE(of, hd44780_ids);
 
+// DT 없이 이름으로 붙일때 (sensor_system/sim의 가짜 adapter, i2c new_device)
+static const struct i2c_device_id hd44780_id[] = {
+	{"hd44780", 0},
+	{},
+};
+MODULE_DEVICE_TABLE(i2c, hd44780_id);
+
 static int i2c_lcd_write_byte(struct i2c_client *client, u8 byte) { // u8: unsigned char
+	struct hd44780_device *hd44780 = i2c_get_clientdata(client);
+	u64 t0 = ktime_get_ns();
 	int ret;
 
-	ret = i2c_smbus_write_byte(client, byte); // 상위 7비트: i2c slave주소, 하위 1비트 R/W 설정, -> i2c_write는 자동으로 하위 1비트를 W로 설정
+	/*
+	 * 상위 7비트: i2c slave주소, 하위 1비트 R/W 설정, -> i2c_write는 자동으로 하위 1비트를 W로 설정
+	 * 바이트마다 스케줄러를 거침 -> SHT20 변환 중 빈 시간에 보내고, fetch가 오면 바로 양보
+	 */
+	ret = jmw_i2c_sched_send(hd44780->sched, JMW_I2C_PRIO_DISPLAY, client, &byte, 1);
+	trace_hd44780_i2c_write(client->addr, byte, ret);
+	jmw_stats_add(&hd44780->stats, 1, ret, ktime_get_ns() - t0);
 
 	if (ret < 0) {
 		printk(KERN_ERR "i2c write fail\n");
@@ -109,31 +164,31 @@ static int i2c_lcd_write_byte(struct i2c_client *client, u8 byte) { // u8: unsig
 }
 
 /*
- * 4비트(데이터)에 나머지 4비트(제어비트) 결합
+ * 인코딩은 hd44780_encode.h
  * @mode: register set (RS)
  * 	- RS:0 명령 전송
  * 	- RS:1 데이터 전송
+ *
+ * 따로 delay 없음: I2C 바이트 하나 (400kHz에서도 ~50us)가
+ * E 펄스 폭 (450ns)과 일반 명령 실행 시간 (37us)보다 김
  */
 static void lcd_send_nibble(struct i2c_client *client, u8 data, u8 mode) {
-	u8 byte_no_e = data | BL | mode;
-	u8 byte_with_e = data | BL | E | mode;
-	
-	i2c_lcd_write_byte(client, byte_no_e); // 펄스 없는 바이트 보냄
-	udelay(10);
+	u8 buf[HD44780_NIBBLE_LEN];
 
-	i2c_lcd_write_byte(client, byte_with_e); // 펄스 있는 바이트 보냄
-	udelay(10);
-
-	i2c_lcd_write_byte(client, byte_no_e); // 펄스 없는 바이트 보냄 -> 하강엣지에서 LCD에 데이터가 들어가게됨
-	udelay(50);
+	hd44780_pack_nibble(buf, data, mode);
+	for (int i = 0; i < HD44780_NIBBLE_LEN; i++)
+		i2c_lcd_write_byte(client, buf[i]);
 }
 
 /*
- * 4bit 모드에서,
+ * 4bit 모드에서, 상위 -> 하위 4비트
  */
 static void lcd_send_byte(struct i2c_client *client, u8 data, u8 mode) {
-	lcd_send_nibble(client, data & 0xF0, mode); // 상위 4비트 보냄
-	lcd_send_nibble(client, (data << 4) & 0xF0, mode); // 하위 4비트 보냄
+	u8 buf[HD44780_BYTE_LEN];
+
+	hd44780_pack_byte(buf, data, mode);
+	for (int i = 0; i < HD44780_BYTE_LEN; i++)
+		i2c_lcd_write_byte(client, buf[i]);
 }
 
 /*
@@ -144,6 +199,10 @@ static void lcd_send_byte(struct i2c_client *client, u8 data, u8 mode) {
  */
 static void lcd_write_cmd(struct i2c_client *client, u8 cmd) {
 	lcd_send_byte(client, cmd, 0x00); // 0x00: RS=0
+
+	// clear display, return home: 실행 시간 1.52ms
+	if (cmd == LCD_CLEARDISPLAY || cmd == LCD_RETURNHOME)
+		usleep_range(1520, 2000);
 }
 
 /* 
@@ -151,24 +210,26 @@ static void lcd_write_cmd(struct i2c_client *client, u8 cmd) {
  * @data: write할 데이터 
  */
 static void lcd_write_data(struct i2c_client *client, char data) {
-	lcd_send_byte(client, data, RS); // 0x01: RS=1
+	lcd_send_byte(client, data, HD44780_RS); // 0x01: RS=1
 }
 
+/*
+ * 데이터시트의 "initializing by instruction" 순서와 대기 시간
+ * (전원 인가 후 40ms, 첫 0x30 후 4.1ms, 두번째 후 100us)
+ */
 static void lcd_init(struct i2c_client *client) {
-	msleep(50);
+	msleep(40);
 
 	// 처음은 8비트 모드
 	lcd_send_nibble(client, 0x30, 0x00);
-	msleep(10);
+	usleep_range(4100, 5000);
 	lcd_send_nibble(client, 0x30, 0x00);
-	udelay(150);
+	udelay(100);
 	lcd_send_nibble(client, 0x30, 0x00);
-	udelay(150);
 	printk(KERN_INFO "8비트 모드로 변경\n");
 
 
 	lcd_send_nibble(client, 0x20, 0x00);
-	udelay(100);	
 	printk(KERN_INFO "4비트 모드로 변경\n");
 
 	lcd_write_cmd(client, LCD_FUNCTIONSET);
@@ -181,17 +242,44 @@ static void lcd_init(struct i2c_client *client) {
 }
 
 static void lcd_print(struct i2c_client *client, const char *str, int len) {
-	printk(KERN_INFO "strlen: %d\n", len);
+	trace_hd44780_flush_start(len);
 
-	for (int i = 0; i < 16; i++) {
+	for (int i = 0; i < LCD_COLS; i++) {
 		if (*str == '\0') {
 			lcd_write_data(client, ' ');
 			continue;
 		}
 		lcd_write_data(client, *str++);
 	}
+
+	trace_hd44780_flush_end(LCD_COLS);
 }
 
+/*
+ * 초기화 끝날때까지 대기
+ * @return: 0 준비 완료, -EAGAIN (O_NONBLOCK), -EIO 초기화 실패, 시그널
+ */
+static int hd44780_wait_ready(struct hd44780_device *hd44780, struct file *file) {
+	int ret;
+
+	if (READ_ONCE(hd44780->state) == HD44780_INIT && (file->f_flags & O_NONBLOCK))
+		return -EAGAIN;
+
+	ret = wait_event_interruptible(hd44780->wq, READ_ONCE(hd44780->state) != HD44780_INIT);
+	if (ret)
+		return ret;
+
+	return READ_ONCE(hd44780->state) == HD44780_READY ? 0 : -EIO;
+}
+
+/*
+ * 락 규칙
+ *  - lock (mutex): LCD에 나가는 바이트 순서 전체. 4비트 모드는 니블 두개가 한 바이트라
+ *    두 writer가 섞이면 LCD가 니블 짝을 잃어버림 (reset 전까지 화면 깨짐)
+ *  - I2C 전송, usleep_range가 안에서 sleep 하므로 process context에서만 (IRQ, spinlock 안 X)
+ *  - init_work는 state가 READY가 되기 전에만 LCD에 쓰고 writer는 그 전에 들어오지 못함 -> lock 불필요
+ *  - copy_from_user (page fault로 sleep 가능)는 lock 밖에서
+ */
 static ssize_t hd44780_write(struct file *file, const char __user *buf, size_t len, loff_t *pos) {
 	struct hd44780_device *hd44780 = file->private_data;
 	char kbuf[32];
@@ -200,28 +288,154 @@ static ssize_t hd44780_write(struct file *file, const char __user *buf, size_t l
 		len = 31;
 
 	int ret;
-	ret = copy_from_user(kbuf, buf, len);
+	ret = hd44780_wait_ready(hd44780, file);
+	if (ret < 0)
+		return ret;
+
+	if (copy_from_user(kbuf, buf, len))
+		return -EFAULT;
+	kbuf[len] = '\0'; // lcd_print는 '\0'까지 출력
+
+	if (file->f_flags & O_NONBLOCK) {
+		if (!mutex_trylock(&hd44780->lock))
+			return -EAGAIN;
+	} else {
+		ret = mutex_lock_interruptible(&hd44780->lock);
+		if (ret)
+			return ret;
+	}
 
 	lcd_write_cmd(hd44780->client, LCD_CLEARDISPLAY);
 	lcd_print(hd44780->client, kbuf, strlen(kbuf));
+	mutex_unlock(&hd44780->lock);
 
 	return len;
 }
 
+/*
+ * 커널 안에서 두 줄 출력 (jmw_bind)
+ * clear (1.52ms, 깜빡임) 대신 줄마다 DDRAM 주소 지정 후 16칸 덮어씀
+ */
+static void hd44780_release(struct kref *ref) {
+	struct hd44780_device *hd44780 = container_of(ref, struct hd44780_device, ref);
+
+	complete(&hd44780->released);
+}
+
+// 이름으로 찾아서 ref 잡기 (없으면 NULL), 다 쓰면 kref_put
+static struct hd44780_device *hd44780_get(const char *dev) {
+	struct hd44780_device *hd44780;
+
+	mutex_lock(&hd44780_list_lock);
+	list_for_each_entry(hd44780, &hd44780_list, node) {
+		if (strcmp(dev_name(&hd44780->client->dev), dev) == 0) {
+			kref_get(&hd44780->ref);
+			mutex_unlock(&hd44780_list_lock);
+			return hd44780;
+		}
+	}
+	mutex_unlock(&hd44780_list_lock);
+
+	return NULL;
+}
+
+int hd44780_print_lines(const char *dev, const char *line0, const char *line1) {
+	struct hd44780_device *hd44780 = hd44780_get(dev);
+	int ret;
+
+	if (hd44780 == NULL)
+		return -ENODEV;
+
+	switch (READ_ONCE(hd44780->state)) {
+	case HD44780_READY:
+		break;
+	case HD44780_INIT:
+		ret = -EAGAIN;
+		goto out;
+	default:
+		ret = -EIO;
+		goto out;
+	}
+
+	mutex_lock(&hd44780->lock);
+	lcd_write_cmd(hd44780->client, LCD_SETDDRAMADDR);
+	lcd_print(hd44780->client, line0, strlen(line0));
+	lcd_write_cmd(hd44780->client, LCD_SETDDRAMADDR | LCD_LINE2);
+	lcd_print(hd44780->client, line1, strlen(line1));
+	mutex_unlock(&hd44780->lock);
+	ret = 0;
+out:
+	kref_put(&hd44780->ref, hd44780_release);
+
+	return ret;
+}
+EXPORT_SYMBOL_GPL(hd44780_print_lines);
+
+/*
+ * 열린 파일마다 ref -> write 중에 remove가 sched, stats를 해제하지 않음
+ * (remove는 파일이 모두 닫힐때까지 기다림)
+ */
 static int hd44780_open(struct inode *inode, struct file *file) {
 	struct hd44780_device *hd44780;
 	hd44780 = container_of(inode->i_cdev, struct hd44780_device, hd44780_cdev);
+	if (!kref_get_unless_zero(&hd44780->ref)) // remove 진행 중
+		return -ENODEV;
 	file->private_data = hd44780;
 
 	return 0;
 }
 
+static int hd44780_close(struct inode *inode, struct file *file) {
+	struct hd44780_device *hd44780 = file->private_data;
+
+	kref_put(&hd44780->ref, hd44780_release);
+	return 0;
+}
+
+/*
+ * 초기화가 끝나면 writable, 실패하면 EPOLLERR
+ */
+static __poll_t hd44780_poll(struct file *file, poll_table *wait) {
+	struct hd44780_device *hd44780 = file->private_data;
+
+	poll_wait(file, &hd44780->wq, wait);
+
+	switch (READ_ONCE(hd44780->state)) {
+	case HD44780_READY:
+		return EPOLLOUT | EPOLLWRNORM;
+	case HD44780_FAILED:
+		return EPOLLERR;
+	default:
+		return 0;
+	}
+}
+
 static const struct file_operations fops = {
 	.owner = THIS_MODULE,
 	.open = hd44780_open,
+	.release = hd44780_close,
 	.write = hd44780_write,
+	.poll = hd44780_poll,
 };
 
+/*
+ * LCD 초기화 (~50ms)를 probe 밖에서 실행
+ */
+static void hd44780_init_work(struct work_struct *work) {
+	struct hd44780_device *hd44780 = container_of(work, struct hd44780_device, init_work);
+	u8 byte = HD44780_BL;
+
+	lcd_init(hd44780->client); // 초기화 작업
+
+	// 첫 바이트가 ACK 안되면 LCD 없음 (i2c_lcd_write_byte는 에러를 삼킴)
+	// 다른 LCD 전송과 같이 스케줄러를 거침 -> SHT20 측정 중간에 끼어들지 않음
+	if (jmw_i2c_sched_send(hd44780->sched, JMW_I2C_PRIO_DISPLAY, hd44780->client, &byte, 1) < 0)
+		WRITE_ONCE(hd44780->state, HD44780_FAILED);
+	else
+		WRITE_ONCE(hd44780->state, HD44780_READY);
+	wake_up_interruptible(&hd44780->wq);
+}
+
 
 static int hd44780_probe(struct i2c_client *client) {
 	struct hd44780_device *hd44780;
@@ -234,14 +448,28 @@ static int hd44780_probe(struct i2c_client *client) {
 	}
 
 	hd44780->client = client;
+	hd44780->state = HD44780_INIT;
+	init_waitqueue_head(&hd44780->wq);
+	mutex_init(&hd44780->lock);
+	INIT_WORK(&hd44780->init_work, hd44780_init_work);
+
+	ret = jmw_stats_init(&hd44780->stats, "hd44780", dev_name(&client->dev));
+	if (ret < 0)
+		return ret;
+
+	hd44780->sched = jmw_i2c_sched_get(client->adapter);
+	if (hd44780->sched == NULL) {
+		jmw_stats_free(&hd44780->stats);
+		return -ENOMEM;
+	}
 
 	i2c_set_clientdata(client, hd44780);
 
-	lcd_init(client); // 초기화 작업
-
 	ret = alloc_chrdev_region(&(hd44780->dev_num), 0, 1, DEVICE_NAME);
 	if (ret < 0) {
 		printk(KERN_ERR "alloc chrdev region fail\n");
+		jmw_i2c_sched_put(hd44780->sched);
+		jmw_stats_free(&hd44780->stats);
 		return -1;
 	}
 
@@ -249,12 +477,22 @@ static int hd44780_probe(struct i2c_client *client) {
 	ret = cdev_add(&(hd44780->hd44780_cdev), hd44780->dev_num, DEVICE_COUNT);
 	if (ret < 0) {
 		printk(KERN_ERR "cdev add fail\n");
+		jmw_i2c_sched_put(hd44780->sched);
+		jmw_stats_free(&hd44780->stats);
 		return -1;
 	}
 
 	hd44780->class = class_create(CLASS_NAME);
 	device_create(hd44780->class, NULL, hd44780->dev_num, NULL, DEVICE_NAME);
 
+	kref_init(&hd44780->ref);
+	init_completion(&hd44780->released);
+	mutex_lock(&hd44780_list_lock);
+	list_add_tail(&hd44780->node, &hd44780_list);
+	mutex_unlock(&hd44780_list_lock);
+
+	schedule_work(&hd44780->init_work); // 끝나면 poll로 알림
+
 	printk(KERN_INFO "probe success\n");
 
 	return 0;
@@ -262,11 +500,23 @@ static int hd44780_probe(struct i2c_client *client) {
 
 static void hd44780_remove(struct i2c_client *client) {
 	struct hd44780_device *hd44780 = i2c_get_clientdata(client);
-	
+
+	// 새로 open 못하게 먼저 내림
 	device_destroy(hd44780->class, hd44780->dev_num);
 	class_destroy(hd44780->class);
 	cdev_del(&(hd44780->hd44780_cdev));
+
+	// 이후로는 못 찾게 하고, 진행 중인 hd44780_print_lines, 열린 파일이 끝나길 기다림
+	mutex_lock(&hd44780_list_lock);
+	list_del(&hd44780->node);
+	mutex_unlock(&hd44780_list_lock);
+	kref_put(&hd44780->ref, hd44780_release);
+	wait_for_completion(&hd44780->released);
+
+	cancel_work_sync(&hd44780->init_work);
 	unregister_chrdev_region(hd44780->dev_num, 1);
+	jmw_stats_free(&hd44780->stats);
+	jmw_i2c_sched_put(hd44780->sched);
 
 	printk(KERN_INFO "remove success\n");
 	return;
@@ -276,7 +526,9 @@ static struct i2c_driver hd44780_driver = {
 	.driver = {
 		.name = "jmw_hd44780",
 		.of_match_table = hd44780_ids,
+		.probe_type = PROBE_PREFER_ASYNCHRONOUS,
 	},
+	.id_table = hd44780_id,
 	.probe = hd44780_probe,
 	.remove = hd44780_remove,
 };
@@ -0,0 +1,42 @@
+#ifndef HD44780_ENCODE_H
+#define HD44780_ENCODE_H
+
+#include <linux/types.h>
+
+/*
+ * PCF8574 출력 바이트 인코딩 (I2C, sleep 없는 순수 계산)
+ * hd44780_driver와 KUnit 등 하드웨어 없는 테스트에서 같이 사용
+ *
+ * BL|E|RW|RS -> 하위 4비트에 들어감
+ * 1 |1|0 |1
+ * D7~D4 -> 상위 4비트
+ */
+#define HD44780_RS (1 << 0)
+#define HD44780_RW (0 << 1) // write만 할거임
+#define HD44780_E (1 << 2) // 펄스
+#define HD44780_BL (1 << 3) // 백라이트
+
+#define HD44780_NIBBLE_LEN 3 // E low -> high -> low
+#define HD44780_BYTE_LEN (2 * HD44780_NIBBLE_LEN)
+
+/*
+ * 4비트(데이터)에 나머지 4비트(제어비트) 결합
+ * E 하강엣지에서 LCD에 데이터가 들어감
+ * @nibble: 상위 4비트만 사용
+ * @mode: 0 명령, HD44780_RS 데이터
+ */
+static inline void hd44780_pack_nibble(u8 *out, u8 nibble, u8 mode) {
+	u8 byte_no_e = (nibble & 0xF0) | HD44780_BL | mode;
+
+	out[0] = byte_no_e;
+	out[1] = byte_no_e | HD44780_E;
+	out[2] = byte_no_e;
+}
+
+// 4비트 모드: 상위 -> 하위 니블
+static inline void hd44780_pack_byte(u8 *out, u8 data, u8 mode) {
+	hd44780_pack_nibble(out, data & 0xF0, mode);
+	hd44780_pack_nibble(out + HD44780_NIBBLE_LEN, data << 4, mode);
+}
+
+#endif
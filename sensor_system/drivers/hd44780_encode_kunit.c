@@ -0,0 +1,112 @@
+#include <kunit/test.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+
+#include "hd44780_encode.h"
+
+/*
+ * hd44780_encode.h KUnit 테스트 + 마이크로벤치마크
+ * 예상값은 PCF8574 배선 (D7~D4 | BL | E | RW | RS) 기준으로 직접 계산한 값
+ */
+
+#define BENCH_BYTES 1000000
+
+static void hd44780_pack_nibble_test(struct kunit *test) {
+	u8 out[HD44780_NIBBLE_LEN];
+	static const u8 cmd[] = { 0xA8, 0xAC, 0xA8 };
+	static const u8 data[] = { 0xA9, 0xAD, 0xA9 };
+
+	hd44780_pack_nibble(out, 0xA0, 0);
+	KUNIT_EXPECT_MEMEQ(test, out, cmd, sizeof(cmd));
+
+	hd44780_pack_nibble(out, 0xA0, HD44780_RS);
+	KUNIT_EXPECT_MEMEQ(test, out, data, sizeof(data));
+
+	// 하위 4비트는 제어비트 자리 -> 데이터에 섞여 있어도 무시
+	hd44780_pack_nibble(out, 0xA5, 0);
+	KUNIT_EXPECT_MEMEQ(test, out, cmd, sizeof(cmd));
+}
+
+static void hd44780_pack_byte_test(struct kunit *test) {
+	static const struct {
+		u8 data;
+		u8 mode;
+		u8 expect[HD44780_BYTE_LEN];
+	} cases[] = {
+		{ 0x00, 0, { 0x08, 0x0C, 0x08, 0x08, 0x0C, 0x08 } },
+		{ 0x01, 0, { 0x08, 0x0C, 0x08, 0x18, 0x1C, 0x18 } }, // clear display
+		{ 0x28, 0, { 0x28, 0x2C, 0x28, 0x88, 0x8C, 0x88 } }, // 4bit, 2 line
+		{ 0x41, HD44780_RS, { 0x49, 0x4D, 0x49, 0x19, 0x1D, 0x19 } }, // 'A'
+		{ 0xFF, HD44780_RS, { 0xF9, 0xFD, 0xF9, 0xF9, 0xFD, 0xF9 } },
+	};
+	u8 out[HD44780_BYTE_LEN];
+
+	for (int i = 0; i < ARRAY_SIZE(cases); i++) {
+		hd44780_pack_byte(out, cases[i].data, cases[i].mode);
+		KUNIT_EXPECT_MEMEQ_MSG(test, out, cases[i].expect, HD44780_BYTE_LEN,
+				       "data 0x%02x mode %u", cases[i].data, cases[i].mode);
+	}
+}
+
+// E는 가운데 바이트에만, 백라이트는 항상 켜짐 (모든 바이트, 모든 모드)
+static void hd44780_pack_byte_invariant_test(struct kunit *test) {
+	u8 out[HD44780_BYTE_LEN];
+
+	for (int data = 0; data < 256; data++) {
+		hd44780_pack_byte(out, data, HD44780_RS);
+		for (int i = 0; i < HD44780_BYTE_LEN; i++) {
+			KUNIT_EXPECT_TRUE(test, out[i] & HD44780_BL);
+			KUNIT_EXPECT_TRUE(test, out[i] & HD44780_RS);
+			KUNIT_EXPECT_EQ(test, !!(out[i] & HD44780_E), i % HD44780_NIBBLE_LEN == 1);
+		}
+		KUNIT_EXPECT_EQ(test, (out[0] & 0xF0) | (out[3] >> 4), data);
+	}
+}
+
+static struct kunit_case hd44780_encode_cases[] = {
+	KUNIT_CASE(hd44780_pack_nibble_test),
+	KUNIT_CASE(hd44780_pack_byte_test),
+	KUNIT_CASE(hd44780_pack_byte_invariant_test),
+	{}
+};
+
+static struct kunit_suite hd44780_encode_suite = {
+	.name = "hd44780_encode",
+	.test_cases = hd44780_encode_cases,
+};
+
+/*
+ * 벤치마크: 16칸 한 줄 = 96 바이트 I2C 버퍼, 이 변환이 버스 시간에 비해 무시할 만한지 확인
+ */
+static void hd44780_pack_byte_bench(struct kunit *test) {
+	u8 out[HD44780_BYTE_LEN];
+	unsigned int sum = 0;
+	u64 t0, ns;
+
+	t0 = ktime_get_ns();
+	for (int i = 0; i < BENCH_BYTES; i++) {
+		hd44780_pack_byte(out, i, HD44780_RS);
+		OPTIMIZER_HIDE_VAR(out[0]);
+		sum += out[0] ^ out[5];
+	}
+	ns = ktime_get_ns() - t0;
+
+	kunit_info(test, "pack_byte: %d bytes in %llu us (%llu ps/byte, sum %u)\n",
+		   BENCH_BYTES, div_u64(ns, NSEC_PER_USEC), div_u64(ns * 1000, BENCH_BYTES), sum);
+	KUNIT_EXPECT_GT(test, ns, 0ULL);
+}
+
+static struct kunit_case hd44780_encode_bench_cases[] = {
+	KUNIT_CASE(hd44780_pack_byte_bench),
+	{}
+};
+
+static struct kunit_suite hd44780_encode_bench_suite = {
+	.name = "hd44780_encode_bench",
+	.test_cases = hd44780_encode_bench_cases,
+};
+
+kunit_test_suites(&hd44780_encode_suite, &hd44780_encode_bench_suite);
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("KUnit tests for the HD44780 PCF8574 byte encoding");
@@ -0,0 +1,61 @@
+/*
+ * HD44780 (PCF8574 I2C 확장 모듈) tracepoints
+ * /sys/kernel/tracing/events/hd44780/
+ */
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM hd44780
+
+#if !defined(_HD44780_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _HD44780_TRACE_H
+
+#include <linux/tracepoint.h>
+
+/* PCF8574로 1바이트 (니블 하나에 3번) */
+TRACE_EVENT(hd44780_i2c_write,
+	TP_PROTO(u16 addr, u8 byte, int ret),
+	TP_ARGS(addr, byte, ret),
+	TP_STRUCT__entry(
+		__field(u16, addr)
+		__field(u8, byte)
+		__field(int, ret)
+	),
+	TP_fast_assign(
+		__entry->addr = addr;
+		__entry->byte = byte;
+		__entry->ret = ret;
+	),
+	TP_printk("addr=0x%02x byte=0x%02x ret=%d", __entry->addr, __entry->byte, __entry->ret)
+);
+
+/* write() 한번: 화면 지우고 cells칸 출력 */
+TRACE_EVENT(hd44780_flush_start,
+	TP_PROTO(int len),
+	TP_ARGS(len),
+	TP_STRUCT__entry(
+		__field(int, len)
+	),
+	TP_fast_assign(
+		__entry->len = len;
+	),
+	TP_printk("len=%d", __entry->len)
+);
+
+TRACE_EVENT(hd44780_flush_end,
+	TP_PROTO(int cells),
+	TP_ARGS(cells),
+	TP_STRUCT__entry(
+		__field(int, cells)
+	),
+	TP_fast_assign(
+		__entry->cells = cells;
+	),
+	TP_printk("cells=%d", __entry->cells)
+);
+
+#endif /* _HD44780_TRACE_H */
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE hd44780_trace
+#include <trace/define_trace.h>
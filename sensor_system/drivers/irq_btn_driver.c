@@ -9,54 +9,145 @@
 #include <linux/device.h>
 #include <linux/uaccess.h>
 #include <linux/wait.h>
+#include <linux/spinlock.h>
 #include <linux/sched.h>
+#include <linux/leds.h>
+#include <linux/poll.h>
+
+#include <linux/ktime.h>
+#include <linux/notifier.h>
+
+#include "jmw_stats.h"
+#include "jmw_export.h"
+
+#define CREATE_TRACE_POINTS
+#include "btn_trace.h"
 
 #define BTN 538
 #define IRQ_NAME "button irq"
 #define DEVICE_NAME "button_device"
 #define DRIVER_NAME "button_driver"
 #define CLASS_NAME "button_class"
+#define TRIGGER_NAME "button-pressed"
+#define TRIGGER_BLINK_MS 100 // 버튼 눌렸을때 LED 켜지는 시간
 
 static int irq_num;
 static dev_t dev_num;
 static struct cdev btn_cdev;
 static struct device *btn_dev;
 static struct class *class;
+
+/*
+ * 락 규칙
+ *  - flag, msg, irq_ns는 hard IRQ와 read()가 같이 씀 -> btn_lock (spinlock)
+ *    IRQ handler는 spin_lock, process context는 spin_lock_irq (안 그러면 같은 CPU에서 IRQ가 들어와 deadlock)
+ *  - lock 안에서는 sleep 금지: copy_to_user, wait_event는 lock 밖에서
+ *  - 누름 하나는 reader 하나만 가져감 (검사 + 0으로 되돌리기가 lock 안에서 한번에)
+ *  - poll은 값만 보므로 READ_ONCE (놓쳐도 wake_up 후 다시 poll)
+ */
+static DEFINE_SPINLOCK(btn_lock);
 static char msg = '0';
 
 static DECLARE_WAIT_QUEUE_HEAD(wq);
 static int flag = 0;
 
+/*
+ * debugfs button/stats
+ * 누름 한번 = 전송 하나, 지연 = IRQ -> reader가 깨어나 값을 가져갈 때까지
+ * 앞 누름을 가져가기 전에 또 눌리면 retries (합쳐진 누름)
+ */
+static struct jmw_stats btn_stats;
+static u64 irq_ns;
+
+DEFINE_LED_TRIGGER(btn_led_trigger);
+
+// 커널 안의 구독자 (jmw_bind 화면 전환), hard IRQ에서 호출
+static ATOMIC_NOTIFIER_HEAD(btn_notifier);
+
+int btn_register_notifier(struct notifier_block *nb) {
+	return atomic_notifier_chain_register(&btn_notifier, nb);
+}
+EXPORT_SYMBOL_GPL(btn_register_notifier);
+
+int btn_unregister_notifier(struct notifier_block *nb) {
+	return atomic_notifier_chain_unregister(&btn_notifier, nb);
+}
+EXPORT_SYMBOL_GPL(btn_unregister_notifier);
+
 static irqreturn_t irq_btn_handler(int irq, void *data) {
+	spin_lock(&btn_lock);
+	if (flag)
+		jmw_stats_retry(&btn_stats);
+	else
+		irq_ns = ktime_get_ns();
 	flag = 1;
-	printk(KERN_INFO "Button pushed!\n");
+	spin_unlock(&btn_lock);
+
+	trace_btn_irq(irq);
+	atomic_notifier_call_chain(&btn_notifier, 0, NULL);
+	// hard IRQ에서 바로 LED 점등, 꺼지는건 LED core의 timer가 처리
+	led_trigger_blink_oneshot(btn_led_trigger, TRIGGER_BLINK_MS, TRIGGER_BLINK_MS, 0);
 	wake_up_interruptible(&wq); // wait queue에 들어가있는 태스크 깨움
 	return IRQ_HANDLED;
 }
 
 static ssize_t read_btn(struct file *file, char __user *buf, size_t len, loff_t *pos) {
-	wait_event_interruptible(wq, flag != 0); // wait queue로 들어감
-	printk(KERN_INFO "read_btn occur\n");
-	
-	flag = 0;
-	if (msg == '0')
-		msg = '1';
-	else
-		msg = '0';
-
+	char value;
+	u64 t0;
 	int ret;
-	ret = copy_to_user(buf, &msg, 1); // 문자 1을 유저 단으로 보냄
-	if (ret < 0) {
+
+	for (;;) {
+		spin_lock_irq(&btn_lock);
+		if (flag) {
+			flag = 0;
+			if (msg == '0')
+				msg = '1';
+			else
+				msg = '0';
+			value = msg;
+			t0 = irq_ns;
+			spin_unlock_irq(&btn_lock);
+			break;
+		}
+		spin_unlock_irq(&btn_lock);
+
+		if (file->f_flags & O_NONBLOCK)
+			return -EAGAIN; // epoll 사용 시 non-blocking read
+
+		ret = wait_event_interruptible(wq, READ_ONCE(flag) != 0); // wait queue로 들어감
+		if (ret)
+			return ret; // 시그널로 깨어남
+		// 같이 깨어난 다른 reader가 먼저 가져갔으면 다시 대기
+	}
+	trace_btn_wakeup(value);
+
+	ret = copy_to_user(buf, &value, 1); // 문자 1을 유저 단으로 보냄
+	jmw_stats_add(&btn_stats, 1, ret ? -EFAULT : 0, ktime_get_ns() - t0);
+	if (ret != 0) {
 		printk(KERN_ERR "copy to user fail\n");
-		return -1;
+		return -EFAULT;
 	}
 
 	return 1;
 }
 
+/*
+ * poll/select/epoll 지원
+ * 버튼이 눌려서 flag가 set되면 readable
+ */
+static __poll_t poll_btn(struct file *file, poll_table *wait) {
+	poll_wait(file, &wq, wait);
+
+	if (READ_ONCE(flag) != 0)
+		return EPOLLIN | EPOLLRDNORM;
+
+	return 0;
+}
+
 static const struct file_operations fops = {
 	.owner = THIS_MODULE,
 	.read = read_btn,
+	.poll = poll_btn,
 };
 
 static int make_chrdev(void) {
@@ -84,22 +175,35 @@ static int make_chrdev(void) {
 
 static int __init btn_init(void) {
 	int ret;
-	
+
+	// irq 받기 전에 등록해둬야 handler에서 바로 사용 가능
+	ret = jmw_stats_init(&btn_stats, "button", NULL);
+	if (ret < 0)
+		return ret;
+	led_trigger_register_simple(TRIGGER_NAME, &btn_led_trigger);
+
 	irq_num = gpio_to_irq(BTN);
 	if (irq_num < 0) {
 		printk(KERN_ERR "gpio to irq fail\n");
+		led_trigger_unregister_simple(btn_led_trigger);
+		jmw_stats_free(&btn_stats);
 		return -1;
 	}
 
 	ret = request_irq(irq_num, irq_btn_handler, IRQF_TRIGGER_RISING, IRQ_NAME, NULL);
 	if (ret < 0) {
 		printk(KERN_ERR "request irq fail\n");
+		led_trigger_unregister_simple(btn_led_trigger);
+		jmw_stats_free(&btn_stats);
 		return -1;
 	}
 
 	ret = make_chrdev();
 	if (ret == -1) {
 		printk(KERN_ERR "create cdev error\n");
+		free_irq(irq_num, NULL);
+		led_trigger_unregister_simple(btn_led_trigger);
+		jmw_stats_free(&btn_stats);
 		return -1;
 	}
 
@@ -109,10 +213,12 @@ static int __init btn_init(void) {
 
 static void __exit btn_exit(void) {
 	free_irq(irq_num, NULL);
+	led_trigger_unregister_simple(btn_led_trigger);
 	device_destroy(class, dev_num);
 	class_destroy(class);
 	cdev_del(&btn_cdev);
 	unregister_chrdev_region(dev_num, 1);
+	jmw_stats_free(&btn_stats);
 	return;
 }
 
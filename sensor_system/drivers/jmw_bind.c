@@ -0,0 +1,720 @@
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+#include <linux/kobject.h>
+#include <linux/sysfs.h>
+#include <linux/mutex.h>
+#include <linux/spinlock.h>
+#include <linux/atomic.h>
+#include <linux/workqueue.h>
+#include <linux/notifier.h>
+#include <linux/ktime.h>
+#include <linux/jiffies.h>
+#include <linux/math64.h>
+
+#include "jmw_export.h"
+
+/*
+ * SHT20 -> LCD 커널 안 binding (app 없이 동작하는 키오스크용)
+ *
+ * 새 sample이 생기면 (누가 read 했든, 주기 측정이든) 바로 layout대로 LCD 두 줄 갱신
+ * refresh_ms 동안 sample이 없으면 직접 측정 -> 유저 프로세스, syscall, 문자열 parse 없음
+ * 버튼 누르면 다음 layout (irq_btn_driver가 로드되어 있을때만, symbol_get)
+ *
+ * /sys/kernel/jmw_bind/
+ *  sensor      SHT20 i2c device 이름 (ex: 1-0040)
+ *  display     LCD i2c device 이름 (ex: 1-0027)
+ *  layouts     layout 목록, 한 줄 (또는 ';')에 하나, 최대 BIND_MAX_LAYOUTS
+ *  layout      현재 layout 번호
+ *  refresh_ms  직접 측정하는 주기 (0: 다른 곳의 sample만 표시)
+ *  enable      1 시작 / 0 정지
+ *  stats       갱신 / 측정 횟수, 에러, 마지막 sample 이후 시간
+ *
+ * layout 항목 (공백으로 구분)
+ *  temp:<row>:<col>[:<prec>[:<unit>]]    온도 (m°C 고정 소수점 -> 소수점 prec자리, 반올림)
+ *  humid:<row>:<col>[:<prec>[:<unit>]]   습도
+ *  text:<row>:<col>:<text>               글자 그대로 ('_'는 공백)
+ *  ex) text:0:0:Temp temp:0:5:1:C text:1:0:Humid humid:1:6:0:%
+ *
+ * 켜는 동안 app (sensord)이 같은 LCD에 쓰면 마지막에 쓴 쪽이 보임
+ */
+
+#define BIND_MAX_LAYOUTS 4
+#define BIND_MAX_ITEMS 8
+#define BIND_NAME_LEN 32
+#define BIND_MAX_PREC 3 // m 단위라 소수점 3자리까지
+#define BIND_MAX_REFRESH_MS 60000
+
+static char *sensor = "";
+module_param(sensor, charp, 0444);
+MODULE_PARM_DESC(sensor, "SHT20 i2c device to bind at load (e.g. 1-0040)");
+
+static char *display = "";
+module_param(display, charp, 0444);
+MODULE_PARM_DESC(display, "HD44780 i2c device to bind at load (e.g. 1-0027), both set = enabled at load");
+
+// app의 MODE temp|humid와 같은 화면, 마지막은 두 값 같이
+static const char *const default_layouts[] = {
+	"text:0:0:Temp: temp:0:6:0",
+	"text:0:0:Humid: humid:0:7:0",
+	"text:0:0:Temp temp:0:6:1:C text:1:0:Humid humid:1:6:1:%",
+};
+
+enum bind_field {
+	BIND_TEXT,
+	BIND_TEMP,
+	BIND_HUMID,
+};
+
+static const char *const field_names[] = {
+	[BIND_TEXT] = "text",
+	[BIND_TEMP] = "temp",
+	[BIND_HUMID] = "humid",
+};
+
+struct bind_item {
+	enum bind_field field;
+	u8 row;
+	u8 col;
+	u8 prec;
+	char text[HD44780_COLS + 1]; // text: 내용, 값: 단위
+};
+
+struct bind_layout {
+	int nr;
+	struct bind_item items[BIND_MAX_ITEMS];
+};
+
+/*
+ * 락 규칙
+ *  - ctl (mutex): enable 전환 (notifier 등록 / 해제, work 취소까지)
+ *  - lock (mutex): display, layouts, render 한번 (LCD 출력 중 sleep)
+ *  - sample_lock (spinlock): sensor 이름, 마지막 sample (SHT20 notifier에서 바로 비교 / 저장)
+ *  - layout: 버튼 notifier가 hard IRQ에서 올림 -> atomic
+ */
+static struct {
+	struct mutex ctl;
+	struct mutex lock;
+	spinlock_t sample_lock;
+
+	char sensor[BIND_NAME_LEN];
+	char display[BIND_NAME_LEN];
+	struct bind_layout layouts[BIND_MAX_LAYOUTS];
+	int nr_layouts;
+	atomic_t layout;
+	unsigned int refresh_ms;
+	bool enabled;
+
+	bool have_sample;
+	int temp_mc;
+	int humid_mpct;
+	u64 sample_ns;
+
+	struct delayed_work refresh;
+	struct work_struct render;
+	struct notifier_block sample_nb;
+	struct notifier_block btn_nb;
+	int (*btn_unregister)(struct notifier_block *nb); // symbol_get 한 경우만
+
+	u64 renders;
+	u64 render_errors;
+	u64 measures;
+	u64 measure_errors;
+
+	struct kobject *kobj;
+} bind;
+
+/* ---- layout ---- */
+
+/*
+ * m 단위 고정 소수점 -> 소수점 prec자리 (반올림), 부동소수점 없음
+ * ex) 25347, 1 -> "25.3"  /  -40, 0 -> "0"
+ */
+static int bind_fmt_milli(char *buf, size_t size, int milli, int prec) {
+	static const int pow10[] = { 1, 10, 100, 1000 };
+	int scale = pow10[BIND_MAX_PREC - prec];
+	int r = (abs(milli) + scale / 2) / scale;
+	const char *sign = (milli < 0 && r) ? "-" : "";
+
+	if (prec == 0)
+		return snprintf(buf, size, "%s%d", sign, r);
+	return snprintf(buf, size, "%s%d.%0*d", sign, r / pow10[prec], prec, r % pow10[prec]);
+}
+
+// field:row:col[:...] 하나
+static int bind_parse_item(char *tok, struct bind_item *item) {
+	char *field = strsep(&tok, ":");
+	char *row = strsep(&tok, ":");
+	char *col = strsep(&tok, ":");
+	char *rest = tok; // text 또는 prec[:unit]
+	unsigned int v;
+	int i;
+
+	memset(item, 0, sizeof(*item));
+
+	i = match_string(field_names, ARRAY_SIZE(field_names), field);
+	if (i < 0)
+		return -EINVAL;
+	item->field = i;
+
+	if (row == NULL || kstrtouint(row, 10, &v) < 0 || v >= HD44780_ROWS)
+		return -EINVAL;
+	item->row = v;
+	if (col == NULL || kstrtouint(col, 10, &v) < 0 || v >= HD44780_COLS)
+		return -EINVAL;
+	item->col = v;
+
+	if (item->field == BIND_TEXT) {
+		if (rest == NULL || *rest == '\0' || strlen(rest) > HD44780_COLS)
+			return -EINVAL;
+		strscpy(item->text, rest, sizeof(item->text));
+		strreplace(item->text, '_', ' ');
+		return 0;
+	}
+
+	item->prec = 1;
+	if (rest != NULL) {
+		char *prec = strsep(&rest, ":");
+
+		if (kstrtouint(prec, 10, &v) < 0 || v > BIND_MAX_PREC)
+			return -EINVAL;
+		item->prec = v;
+		if (rest != NULL && strscpy(item->text, rest, sizeof(item->text)) < 0)
+			return -E2BIG;
+	}
+	return 0;
+}
+
+// 공백으로 구분된 항목들 -> layout 하나
+static int bind_parse_layout(char *spec, struct bind_layout *layout) {
+	char *tok;
+	int ret;
+
+	layout->nr = 0;
+	while ((tok = strsep(&spec, " \t")) != NULL) {
+		if (*tok == '\0')
+			continue;
+		if (layout->nr == BIND_MAX_ITEMS)
+			return -E2BIG;
+		ret = bind_parse_item(tok, &layout->items[layout->nr]);
+		if (ret < 0)
+			return ret;
+		layout->nr++;
+	}
+	return layout->nr ? 0 : -EINVAL;
+}
+
+/*
+ * layout 여러개 (줄바꿈 또는 ';'로 구분), 빈 layout은 건너뜀
+ * @return: layout 수, 음수 에러
+ */
+static int bind_parse_layouts(const char *buf, struct bind_layout *layouts) {
+	char *copy = kstrdup(buf, GFP_KERNEL);
+	char *spec;
+	char *p;
+	int nr = 0;
+	int ret = 0;
+
+	if (copy == NULL)
+		return -ENOMEM;
+
+	p = copy;
+	while ((spec = strsep(&p, ";\n")) != NULL) {
+		spec = strim(spec);
+		if (*spec == '\0')
+			continue;
+		if (nr == BIND_MAX_LAYOUTS) {
+			ret = -E2BIG;
+			break;
+		}
+		ret = bind_parse_layout(spec, &layouts[nr]);
+		if (ret < 0)
+			break;
+		nr++;
+	}
+	kfree(copy);
+
+	if (ret < 0)
+		return ret;
+	return nr ? nr : -EINVAL;
+}
+
+// 16칸 두 줄에 항목 하나, 줄 끝에서 잘림
+static void bind_put(char lines[HD44780_ROWS][HD44780_COLS + 1], const struct bind_item *item, const char *str) {
+	char *dst = &lines[item->row][item->col];
+	int room = HD44780_COLS - item->col;
+
+	memcpy(dst, str, min_t(int, strlen(str), room));
+}
+
+/*
+ * @bind.lock 잡은 상태에서 호출
+ */
+static void bind_render_lines(const struct bind_layout *layout, bool have, int temp_mc, int humid_mpct,
+			      char lines[HD44780_ROWS][HD44780_COLS + 1]) {
+	for (int r = 0; r < HD44780_ROWS; r++) {
+		memset(lines[r], ' ', HD44780_COLS);
+		lines[r][HD44780_COLS] = '\0';
+	}
+
+	for (int i = 0; i < layout->nr; i++) {
+		const struct bind_item *item = &layout->items[i];
+		char str[2 * HD44780_COLS + 2];
+		int len;
+
+		if (item->field == BIND_TEXT) {
+			bind_put(lines, item, item->text);
+			continue;
+		}
+
+		if (!have)
+			len = snprintf(str, sizeof(str), "--");
+		else
+			len = bind_fmt_milli(str, sizeof(str), item->field == BIND_TEMP ? temp_mc : humid_mpct, item->prec);
+		snprintf(str + len, sizeof(str) - len, "%s", item->text);
+		bind_put(lines, item, str);
+	}
+}
+
+/* ---- work / notifier ---- */
+
+static void bind_render_work(struct work_struct *work) {
+	char lines[HD44780_ROWS][HD44780_COLS + 1];
+	bool have;
+	int temp_mc;
+	int humid_mpct;
+	int idx;
+	int ret;
+
+	spin_lock(&bind.sample_lock);
+	have = bind.have_sample;
+	temp_mc = bind.temp_mc;
+	humid_mpct = bind.humid_mpct;
+	spin_unlock(&bind.sample_lock);
+
+	mutex_lock(&bind.lock);
+	if (!bind.enabled) {
+		mutex_unlock(&bind.lock);
+		return;
+	}
+
+	idx = (unsigned int)atomic_read(&bind.layout) % bind.nr_layouts;
+	bind_render_lines(&bind.layouts[idx], have, temp_mc, humid_mpct, lines);
+
+	ret = hd44780_print_lines(bind.display, lines[0], lines[1]);
+	if (ret < 0)
+		bind.render_errors++;
+	else
+		bind.renders++;
+	mutex_unlock(&bind.lock);
+}
+
+/*
+ * refresh_ms 동안 sample이 없을때만 실행 (새 sample이 올때마다 뒤로 밀림)
+ * 측정 결과는 notifier를 거쳐 bind_on_sample로 들어옴
+ */
+static void bind_refresh_work(struct work_struct *work) {
+	char name[BIND_NAME_LEN];
+	struct sht20_sample sample;
+	unsigned int ms;
+	int ret;
+
+	spin_lock(&bind.sample_lock);
+	strscpy(name, bind.sensor, sizeof(name));
+	spin_unlock(&bind.sample_lock);
+
+	ret = sht20_measure(name, &sample); // ~115ms sleep
+	mutex_lock(&bind.lock);
+	bind.measures++;
+	bind.measure_errors += ret < 0;
+	mutex_unlock(&bind.lock);
+
+	ms = READ_ONCE(bind.refresh_ms);
+	if (ms && READ_ONCE(bind.enabled))
+		schedule_delayed_work(&bind.refresh, msecs_to_jiffies(ms)); // 성공했으면 이미 예약됨
+}
+
+// SHT20 read() / sht20_measure 뒤 (process context)
+static int bind_on_sample(struct notifier_block *nb, unsigned long action, void *data) {
+	struct sht20_sample *s = data;
+	unsigned int ms;
+
+	spin_lock(&bind.sample_lock);
+	if (strcmp(s->dev, bind.sensor) != 0) {
+		spin_unlock(&bind.sample_lock);
+		return NOTIFY_DONE;
+	}
+	bind.have_sample = true;
+	bind.temp_mc = s->temp_mc;
+	bind.humid_mpct = s->humid_mpct;
+	bind.sample_ns = s->ts_ns;
+	spin_unlock(&bind.sample_lock);
+
+	queue_work(system_wq, &bind.render);
+
+	// 방금 sample이 있으니 직접 측정은 한 주기 뒤로
+	ms = READ_ONCE(bind.refresh_ms);
+	if (ms)
+		mod_delayed_work(system_wq, &bind.refresh, msecs_to_jiffies(ms));
+
+	return NOTIFY_OK;
+}
+
+// hard IRQ: 번호만 올리고 그리기는 work에서
+static int bind_on_button(struct notifier_block *nb, unsigned long action, void *data) {
+	atomic_inc(&bind.layout);
+	queue_work(system_wq, &bind.render);
+	return NOTIFY_OK;
+}
+
+/* ---- enable ---- */
+
+static int bind_start(void) {
+	int (*btn_register)(struct notifier_block *nb);
+	int ret;
+
+	mutex_lock(&bind.ctl);
+	if (bind.enabled) {
+		mutex_unlock(&bind.ctl);
+		return 0;
+	}
+	if (bind.sensor[0] == '\0' || bind.display[0] == '\0') {
+		mutex_unlock(&bind.ctl);
+		return -EINVAL;
+	}
+
+	ret = sht20_register_notifier(&bind.sample_nb);
+	if (ret < 0) {
+		mutex_unlock(&bind.ctl);
+		return ret;
+	}
+
+	// 버튼은 선택: 드라이버가 없으면 layout 전환만 안됨
+	btn_register = symbol_get(btn_register_notifier);
+	if (btn_register != NULL) {
+		bind.btn_unregister = symbol_get(btn_unregister_notifier);
+		if (bind.btn_unregister == NULL || btn_register(&bind.btn_nb) < 0) {
+			if (bind.btn_unregister != NULL)
+				symbol_put(btn_unregister_notifier);
+			bind.btn_unregister = NULL;
+		}
+		symbol_put(btn_register_notifier);
+	}
+
+	mutex_lock(&bind.lock);
+	bind.enabled = true;
+	mutex_unlock(&bind.lock);
+
+	queue_work(system_wq, &bind.render); // 측정 전에 layout 먼저 (값은 --)
+	mod_delayed_work(system_wq, &bind.refresh, 0);
+	mutex_unlock(&bind.ctl);
+
+	return 0;
+}
+
+static void bind_stop(void) {
+	mutex_lock(&bind.ctl);
+	if (!bind.enabled) {
+		mutex_unlock(&bind.ctl);
+		return;
+	}
+
+	mutex_lock(&bind.lock);
+	bind.enabled = false;
+	mutex_unlock(&bind.lock);
+
+	// notifier 먼저 해제해야 work가 다시 예약되지 않음
+	sht20_unregister_notifier(&bind.sample_nb);
+	if (bind.btn_unregister != NULL) {
+		bind.btn_unregister(&bind.btn_nb);
+		symbol_put(btn_unregister_notifier);
+		bind.btn_unregister = NULL;
+	}
+	cancel_delayed_work_sync(&bind.refresh);
+	cancel_work_sync(&bind.render);
+
+	spin_lock(&bind.sample_lock);
+	bind.have_sample = false;
+	spin_unlock(&bind.sample_lock);
+	mutex_unlock(&bind.ctl);
+}
+
+/* ---- sysfs ---- */
+
+static ssize_t bind_name_store(char *dst, const char *buf, size_t count) {
+	char name[BIND_NAME_LEN];
+
+	if (strscpy(name, buf, sizeof(name)) < 0)
+		return -E2BIG;
+
+	// 바꾸면 이전 장치의 값은 버림
+	spin_lock(&bind.sample_lock);
+	strscpy(dst, strim(name), BIND_NAME_LEN);
+	if (dst == bind.sensor)
+		bind.have_sample = false;
+	spin_unlock(&bind.sample_lock);
+	return count;
+}
+
+static ssize_t sensor_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf) {
+	ssize_t len;
+
+	spin_lock(&bind.sample_lock);
+	len = sysfs_emit(buf, "%s\n", bind.sensor);
+	spin_unlock(&bind.sample_lock);
+	return len;
+}
+
+static ssize_t sensor_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count) {
+	return bind_name_store(bind.sensor, buf, count);
+}
+static struct kobj_attribute sensor_attr = __ATTR_RW(sensor);
+
+static ssize_t display_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf) {
+	ssize_t len;
+
+	spin_lock(&bind.sample_lock);
+	len = sysfs_emit(buf, "%s\n", bind.display);
+	spin_unlock(&bind.sample_lock);
+	return len;
+}
+
+// render가 읽는 중에 바뀌지 않게 bind.lock도 잡음
+static ssize_t display_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count) {
+	ssize_t ret;
+
+	mutex_lock(&bind.lock);
+	ret = bind_name_store(bind.display, buf, count);
+	mutex_unlock(&bind.lock);
+	if (ret > 0)
+		queue_work(system_wq, &bind.render);
+	return ret;
+}
+static struct kobj_attribute display_attr = __ATTR_RW(display);
+
+static ssize_t layouts_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf) {
+	int len = 0;
+
+	mutex_lock(&bind.lock);
+	for (int l = 0; l < bind.nr_layouts; l++) {
+		const struct bind_layout *layout = &bind.layouts[l];
+
+		for (int i = 0; i < layout->nr; i++) {
+			const struct bind_item *item = &layout->items[i];
+			char text[HD44780_COLS + 1];
+
+			len += sysfs_emit_at(buf, len, "%s%s:%u:%u", i ? " " : "", field_names[item->field],
+					     item->row, item->col);
+			if (item->field == BIND_TEXT) {
+				strscpy(text, item->text, sizeof(text));
+				strreplace(text, ' ', '_');
+				len += sysfs_emit_at(buf, len, ":%s", text);
+			} else {
+				len += sysfs_emit_at(buf, len, ":%u%s%s", item->prec, item->text[0] ? ":" : "",
+						     item->text);
+			}
+		}
+		len += sysfs_emit_at(buf, len, "\n");
+	}
+	mutex_unlock(&bind.lock);
+	return len;
+}
+
+// 전부 parse 성공해야 교체, layout 번호는 0부터
+static ssize_t layouts_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count) {
+	struct bind_layout *layouts;
+	int nr;
+
+	layouts = kcalloc(BIND_MAX_LAYOUTS, sizeof(*layouts), GFP_KERNEL);
+	if (layouts == NULL)
+		return -ENOMEM;
+
+	nr = bind_parse_layouts(buf, layouts);
+	if (nr < 0) {
+		kfree(layouts);
+		return nr;
+	}
+
+	mutex_lock(&bind.lock);
+	memcpy(bind.layouts, layouts, nr * sizeof(*layouts));
+	bind.nr_layouts = nr;
+	atomic_set(&bind.layout, 0);
+	mutex_unlock(&bind.lock);
+	kfree(layouts);
+
+	queue_work(system_wq, &bind.render);
+	return count;
+}
+static struct kobj_attribute layouts_attr = __ATTR_RW(layouts);
+
+static ssize_t layout_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf) {
+	ssize_t len;
+
+	mutex_lock(&bind.lock);
+	len = sysfs_emit(buf, "%u\n", (unsigned int)atomic_read(&bind.layout) % bind.nr_layouts);
+	mutex_unlock(&bind.lock);
+	return len;
+}
+
+static ssize_t layout_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count) {
+	unsigned int v;
+
+	if (kstrtouint(buf, 0, &v) < 0)
+		return -EINVAL;
+
+	mutex_lock(&bind.lock);
+	if (v >= bind.nr_layouts) {
+		mutex_unlock(&bind.lock);
+		return -EINVAL;
+	}
+	atomic_set(&bind.layout, v);
+	mutex_unlock(&bind.lock);
+
+	queue_work(system_wq, &bind.render);
+	return count;
+}
+static struct kobj_attribute layout_attr = __ATTR_RW(layout);
+
+static ssize_t refresh_ms_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf) {
+	return sysfs_emit(buf, "%u\n", READ_ONCE(bind.refresh_ms));
+}
+
+static ssize_t refresh_ms_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count) {
+	unsigned int ms;
+
+	if (kstrtouint(buf, 0, &ms) < 0 || ms > BIND_MAX_REFRESH_MS)
+		return -EINVAL;
+
+	// bind_stop의 cancel 뒤에 다시 예약되지 않게 ctl 안에서 확인
+	mutex_lock(&bind.ctl);
+	WRITE_ONCE(bind.refresh_ms, ms);
+	if (ms && bind.enabled)
+		mod_delayed_work(system_wq, &bind.refresh, msecs_to_jiffies(ms));
+	mutex_unlock(&bind.ctl);
+	return count;
+}
+static struct kobj_attribute refresh_ms_attr = __ATTR_RW(refresh_ms);
+
+static ssize_t enable_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf) {
+	return sysfs_emit(buf, "%d\n", READ_ONCE(bind.enabled));
+}
+
+static ssize_t enable_store(struct kobject *kobj, struct kobj_attribute *attr, const char *buf, size_t count) {
+	bool on;
+	int ret;
+
+	if (kstrtobool(buf, &on) < 0)
+		return -EINVAL;
+
+	if (!on) {
+		bind_stop();
+		return count;
+	}
+
+	ret = bind_start();
+	return ret < 0 ? ret : count;
+}
+static struct kobj_attribute enable_attr = __ATTR_RW(enable);
+
+static ssize_t stats_show(struct kobject *kobj, struct kobj_attribute *attr, char *buf) {
+	u64 sample_ns;
+	bool have;
+	int len = 0;
+
+	spin_lock(&bind.sample_lock);
+	have = bind.have_sample;
+	sample_ns = bind.sample_ns;
+	spin_unlock(&bind.sample_lock);
+
+	mutex_lock(&bind.lock);
+	len += sysfs_emit_at(buf, len, "renders: %llu\n", bind.renders);
+	len += sysfs_emit_at(buf, len, "render_errors: %llu\n", bind.render_errors);
+	len += sysfs_emit_at(buf, len, "measures: %llu\n", bind.measures);
+	len += sysfs_emit_at(buf, len, "measure_errors: %llu\n", bind.measure_errors);
+	mutex_unlock(&bind.lock);
+
+	if (have)
+		len += sysfs_emit_at(buf, len, "sample_age_ms: %llu\n",
+				     div_u64(ktime_get_ns() - sample_ns, NSEC_PER_MSEC));
+	else
+		len += sysfs_emit_at(buf, len, "sample_age_ms: -\n");
+	return len;
+}
+static struct kobj_attribute stats_attr = __ATTR_RO(stats);
+
+static struct attribute *bind_attrs[] = {
+	&sensor_attr.attr,
+	&display_attr.attr,
+	&layouts_attr.attr,
+	&layout_attr.attr,
+	&refresh_ms_attr.attr,
+	&enable_attr.attr,
+	&stats_attr.attr,
+	NULL,
+};
+
+static const struct attribute_group bind_group = {
+	.attrs = bind_attrs,
+};
+
+static int __init jmw_bind_init(void) {
+	int ret;
+
+	mutex_init(&bind.ctl);
+	mutex_init(&bind.lock);
+	spin_lock_init(&bind.sample_lock);
+	INIT_DELAYED_WORK(&bind.refresh, bind_refresh_work);
+	INIT_WORK(&bind.render, bind_render_work);
+	bind.sample_nb.notifier_call = bind_on_sample;
+	bind.btn_nb.notifier_call = bind_on_button;
+	bind.refresh_ms = 1000; // app 기본 측정 주기와 같음
+
+	for (int i = 0; i < ARRAY_SIZE(default_layouts); i++) {
+		ret = bind_parse_layouts(default_layouts[i], &bind.layouts[i]);
+		if (ret < 0)
+			return ret;
+	}
+	bind.nr_layouts = ARRAY_SIZE(default_layouts);
+
+	strscpy(bind.sensor, sensor, sizeof(bind.sensor));
+	strscpy(bind.display, display, sizeof(bind.display));
+
+	bind.kobj = kobject_create_and_add("jmw_bind", kernel_kobj);
+	if (bind.kobj == NULL)
+		return -ENOMEM;
+
+	ret = sysfs_create_group(bind.kobj, &bind_group);
+	if (ret < 0) {
+		printk(KERN_ERR "sysfs create group fail\n");
+		kobject_put(bind.kobj);
+		return ret;
+	}
+
+	// 파라미터로 둘 다 주면 바로 시작 (modprobe.d 설정만으로 키오스크 동작)
+	if (bind.sensor[0] && bind.display[0]) {
+		ret = bind_start();
+		if (ret < 0)
+			printk(KERN_ERR "jmw_bind start fail\n");
+	}
+
+	return 0;
+}
+
+static void __exit jmw_bind_exit(void) {
+	// sysfs 먼저 내림 (실행 중인 store가 끝날때까지 기다림) -> 이후 enable로 다시 시작될 수 없음
+	sysfs_remove_group(bind.kobj, &bind_group);
+	bind_stop();
+	kobject_put(bind.kobj);
+
+	// display / layout store는 enable과 상관없이 render를 예약함 -> 남은 것 정리
+	cancel_delayed_work_sync(&bind.refresh);
+	cancel_work_sync(&bind.render);
+}
+
+module_init(jmw_bind_init);
+module_exit(jmw_bind_exit);
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("In-kernel SHT20 to HD44780 display binding");
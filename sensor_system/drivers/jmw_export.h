@@ -0,0 +1,47 @@
+#ifndef JMW_EXPORT_H
+#define JMW_EXPORT_H
+
+#include <linux/types.h>
+#include <linux/notifier.h>
+
+/*
+ * 드라이버끼리 쓰는 export 심볼 (jmw_bind 등 커널 안의 사용자용)
+ * 인스턴스는 i2c device 이름으로 찾음 (ex: SHT20 "1-0040", LCD "1-0027")
+ * 모두 process context (sleep 가능), 버튼 notifier 콜백만 hard IRQ에서 불림
+ */
+
+/* sht20_driver */
+struct sht20_sample {
+	const char *dev; // 측정한 인스턴스 (콜백 안에서만 유효)
+	int temp_mc;
+	int humid_mpct;
+	u64 ts_ns; // ktime_get_ns
+};
+
+/*
+ * 온도 + 습도 측정 (~115ms, 다른 측정과 직렬화)
+ * 성공하면 notifier에도 같은 sample이 감
+ * @return: 0, -ENODEV 없음, -EAGAIN 초기화 중, -EIO
+ */
+int sht20_measure(const char *dev, struct sht20_sample *out);
+
+/* 새 sample마다 (read(), sht20_measure) 호출, data = struct sht20_sample * */
+int sht20_register_notifier(struct notifier_block *nb);
+int sht20_unregister_notifier(struct notifier_block *nb);
+
+/* hd44780_driver */
+#define HD44780_ROWS 2
+#define HD44780_COLS 16
+
+/*
+ * 두 줄 출력 (clear 없이 덮어씀, 16칸보다 짧으면 공백)
+ * char device write()와 같은 lock으로 직렬화
+ * @return: 0, -ENODEV 없음, -EAGAIN 초기화 중, -EIO 초기화 실패
+ */
+int hd44780_print_lines(const char *dev, const char *line0, const char *line1);
+
+/* irq_btn_driver: 누를때마다 hard IRQ에서 호출 -> 콜백은 sleep 금지 */
+int btn_register_notifier(struct notifier_block *nb);
+int btn_unregister_notifier(struct notifier_block *nb);
+
+#endif
@@ -0,0 +1,242 @@
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/slab.h>
+#include <linux/i2c.h>
+#include <linux/list.h>
+#include <linux/kref.h>
+#include <linux/mutex.h>
+#include <linux/atomic.h>
+#include <linux/wait.h>
+#include <linux/ktime.h>
+#include <linux/jiffies.h>
+#include <linux/math64.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+
+#include "jmw_i2c_sched.h"
+
+/*
+ * 스케줄러 하나 = adapter 하나
+ *
+ * 락 규칙
+ *  - bus (mutex): 이 스케줄러를 통한 전송은 한번에 하나, 통계도 이 lock으로 보호
+ *    i2c core의 adapter lock과 별개 (스케줄러 밖의 전송은 그냥 섞임)
+ *  - sensor_waiting, fetch_at: lock 없이 읽음 -> DISPLAY는 bus를 잡은 뒤 한번 더 확인
+ *  - scheds_lock: adapter -> 스케줄러 목록과 refcount
+ *
+ * DISPLAY가 기다리는 최대 시간은 max_yield_ms, 넘으면 그냥 보냄
+ * (예약해 놓고 fetch를 못한 센서 때문에 화면이 멈추지 않게)
+ *
+ * /sys/kernel/debug/jmw_i2c_sched/i2c-<n>: 우선순위별 전송 수, 양보 횟수, 대기 시간
+ */
+
+static unsigned int max_yield_ms = 100;
+module_param(max_yield_ms, uint, 0644);
+MODULE_PARM_DESC(max_yield_ms, "longest a display transfer waits for the sensor");
+
+struct jmw_i2c_sched {
+	struct list_head node;
+	struct kref ref;
+	struct i2c_adapter *adap;
+	u32 bus_hz; // DT clock-frequency (없으면 100 kHz)
+
+	struct mutex bus;
+	atomic_t sensor_waiting;
+	atomic64_t fetch_at; // 0이면 예약 없음
+	wait_queue_head_t wq;
+
+	u64 xfers[2]; // 우선순위별
+	u64 yields; // DISPLAY가 기다린 횟수
+	u64 overruns; // max_yield_ms 넘어서 그냥 보낸 횟수
+	u64 display_wait_ns;
+	u64 sensor_wait_max_ns; // SENSOR가 bus를 얻기까지 (앞 전송 하나)
+
+	struct dentry *file;
+};
+
+static LIST_HEAD(scheds);
+static DEFINE_MUTEX(scheds_lock);
+static struct dentry *debugfs_dir;
+
+// 컨트롤러 IRQ, 스케줄링 여유 (bcm2835 바이트 전송 한번에 수십 us)
+#define XFER_OVERHEAD_NS 50000
+
+/*
+ * START + (주소 + 데이터) * 9 (ACK 포함) + STOP
+ */
+static u64 sched_xfer_ns(struct jmw_i2c_sched *s, int len) {
+	return div_u64((u64)(2 + 9 * (1 + len)) * NSEC_PER_SEC, s->bus_hz) + XFER_OVERHEAD_NS;
+}
+
+// 이 길이의 전송이 예약된 fetch 전에 끝나는지
+static bool sched_display_fits(struct jmw_i2c_sched *s, int len) {
+	u64 fetch_at = atomic64_read(&s->fetch_at);
+
+	if (atomic_read(&s->sensor_waiting))
+		return false;
+	return fetch_at == 0 || ktime_get_ns() + sched_xfer_ns(s, len) <= fetch_at;
+}
+
+static void sched_begin(struct jmw_i2c_sched *s, enum jmw_i2c_prio prio, int len) {
+	u64 t0 = ktime_get_ns();
+	bool yielded = false;
+	bool overrun = false;
+	long timeout;
+
+	if (prio == JMW_I2C_PRIO_SENSOR) {
+		atomic_inc(&s->sensor_waiting);
+		mutex_lock(&s->bus);
+		atomic_dec(&s->sensor_waiting);
+		s->sensor_wait_max_ns = max(s->sensor_wait_max_ns, ktime_get_ns() - t0);
+		s->xfers[prio]++;
+		return;
+	}
+
+	timeout = msecs_to_jiffies(READ_ONCE(max_yield_ms));
+	for (;;) {
+		if (!sched_display_fits(s, len)) {
+			yielded = true;
+			/*
+			 * fetch 예약은 release에서 wake_up, 다만 예약 시각이 지나도 센서가 안오면
+			 * 조건이 시간으로만 바뀌지 않으므로 timeout으로 끊음
+			 */
+			timeout = wait_event_timeout(s->wq, sched_display_fits(s, len), timeout);
+			if (timeout == 0)
+				overrun = true;
+		}
+
+		mutex_lock(&s->bus);
+		if (overrun || sched_display_fits(s, len))
+			break;
+		mutex_unlock(&s->bus); // bus를 잡는 사이에 SENSOR가 들어옴
+	}
+
+	s->xfers[prio]++;
+	s->yields += yielded;
+	s->overruns += overrun;
+	s->display_wait_ns += ktime_get_ns() - t0;
+}
+
+static void sched_end(struct jmw_i2c_sched *s) {
+	mutex_unlock(&s->bus);
+	wake_up(&s->wq);
+}
+
+int jmw_i2c_sched_send(struct jmw_i2c_sched *s, enum jmw_i2c_prio prio,
+		       const struct i2c_client *client, const char *buf, int len) {
+	int ret;
+
+	sched_begin(s, prio, len);
+	ret = i2c_master_send(client, buf, len);
+	sched_end(s);
+	return ret;
+}
+EXPORT_SYMBOL_GPL(jmw_i2c_sched_send);
+
+int jmw_i2c_sched_recv(struct jmw_i2c_sched *s, enum jmw_i2c_prio prio,
+		       const struct i2c_client *client, char *buf, int len) {
+	int ret;
+
+	sched_begin(s, prio, len);
+	ret = i2c_master_recv(client, buf, len);
+	sched_end(s);
+	return ret;
+}
+EXPORT_SYMBOL_GPL(jmw_i2c_sched_recv);
+
+void jmw_i2c_sched_reserve(struct jmw_i2c_sched *s, u64 at_ns) {
+	atomic64_set(&s->fetch_at, at_ns);
+}
+EXPORT_SYMBOL_GPL(jmw_i2c_sched_reserve);
+
+void jmw_i2c_sched_release(struct jmw_i2c_sched *s) {
+	atomic64_set(&s->fetch_at, 0);
+	wake_up(&s->wq);
+}
+EXPORT_SYMBOL_GPL(jmw_i2c_sched_release);
+
+static int sched_show(struct seq_file *m, void *v) {
+	struct jmw_i2c_sched *s = m->private;
+
+	mutex_lock(&s->bus);
+	seq_printf(m, "bus_hz: %u\n", s->bus_hz);
+	seq_printf(m, "sensor_xfers: %llu\n", s->xfers[JMW_I2C_PRIO_SENSOR]);
+	seq_printf(m, "display_xfers: %llu\n", s->xfers[JMW_I2C_PRIO_DISPLAY]);
+	seq_printf(m, "display_yields: %llu\n", s->yields);
+	seq_printf(m, "display_overruns: %llu\n", s->overruns);
+	seq_printf(m, "display_wait_us: %llu\n", div_u64(s->display_wait_ns, NSEC_PER_USEC));
+	seq_printf(m, "sensor_wait_max_us: %llu\n", div_u64(s->sensor_wait_max_ns, NSEC_PER_USEC));
+	mutex_unlock(&s->bus);
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(sched);
+
+struct jmw_i2c_sched *jmw_i2c_sched_get(struct i2c_adapter *adap) {
+	struct i2c_timings t = {};
+	struct jmw_i2c_sched *s;
+
+	mutex_lock(&scheds_lock);
+	list_for_each_entry(s, &scheds, node) {
+		if (s->adap == adap) {
+			kref_get(&s->ref);
+			mutex_unlock(&scheds_lock);
+			return s;
+		}
+	}
+
+	s = kzalloc(sizeof(*s), GFP_KERNEL);
+	if (s == NULL) {
+		mutex_unlock(&scheds_lock);
+		return NULL;
+	}
+
+	kref_init(&s->ref);
+	s->adap = adap;
+	mutex_init(&s->bus);
+	init_waitqueue_head(&s->wq);
+
+	i2c_parse_fw_timings(&adap->dev, &t, true); // 없으면 100 kHz
+	s->bus_hz = t.bus_freq_hz;
+
+	s->file = debugfs_create_file(dev_name(&adap->dev), 0444, debugfs_dir, s, &sched_fops);
+	list_add(&s->node, &scheds);
+	mutex_unlock(&scheds_lock);
+
+	return s;
+}
+EXPORT_SYMBOL_GPL(jmw_i2c_sched_get);
+
+static void sched_free(struct kref *ref) {
+	struct jmw_i2c_sched *s = container_of(ref, struct jmw_i2c_sched, ref);
+
+	list_del(&s->node);
+	debugfs_remove(s->file);
+	kfree(s);
+}
+
+void jmw_i2c_sched_put(struct jmw_i2c_sched *s) {
+	if (s == NULL)
+		return;
+
+	mutex_lock(&scheds_lock);
+	kref_put(&s->ref, sched_free);
+	mutex_unlock(&scheds_lock);
+}
+EXPORT_SYMBOL_GPL(jmw_i2c_sched_put);
+
+static int __init jmw_i2c_sched_init(void) {
+	debugfs_dir = debugfs_create_dir("jmw_i2c_sched", NULL);
+	return 0;
+}
+
+// 사용하는 드라이버가 남아 있으면 rmmod 안됨 (심볼 의존성) -> 여기서는 목록이 비어있음
+static void __exit jmw_i2c_sched_exit(void) {
+	debugfs_remove_recursive(debugfs_dir);
+}
+
+module_init(jmw_i2c_sched_init);
+module_exit(jmw_i2c_sched_exit);
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("Per-adapter I2C transfer scheduler for the SHT20 and HD44780 drivers");
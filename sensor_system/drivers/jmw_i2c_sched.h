@@ -0,0 +1,47 @@
+#ifndef JMW_I2C_SCHED_H
+#define JMW_I2C_SCHED_H
+
+#include <linux/types.h>
+#include <linux/i2c.h>
+
+/*
+ * adapter별 I2C 전송 스케줄러 (jmw_i2c_sched.ko)
+ *
+ * SHT20 (0x40)과 LCD (0x27)가 같은 i2c_arm 버스를 씀
+ *  - SHT20은 no-hold 측정: 명령 -> (변환 중 버스 비어있음) -> 결과 fetch
+ *  - LCD 전송은 그 빈 시간에: fetch 예약 시각 전에 끝나는 전송만 통과
+ *  - SENSOR 우선순위가 기다리고 있으면 DISPLAY는 양보 (바이트 단위로 끼어듦)
+ * -> 갱신 한번 = max(변환, 화면) 정도 (기존: 변환 + 화면)
+ *
+ * 같은 adapter의 드라이버는 get으로 같은 스케줄러를 공유
+ * send / recv는 sleep (process context 전용)
+ */
+
+enum jmw_i2c_prio {
+	JMW_I2C_PRIO_SENSOR, // 측정 명령 / fetch: 절대 늦추지 않음
+	JMW_I2C_PRIO_DISPLAY, // LCD: 남는 시간에
+};
+
+struct jmw_i2c_sched;
+
+struct jmw_i2c_sched *jmw_i2c_sched_get(struct i2c_adapter *adap);
+void jmw_i2c_sched_put(struct jmw_i2c_sched *s);
+
+/*
+ * i2c_master_send / i2c_master_recv와 같은 반환값
+ * DISPLAY는 SENSOR가 대기 중이거나 예약된 fetch에 걸리면 먼저 기다림
+ */
+int jmw_i2c_sched_send(struct jmw_i2c_sched *s, enum jmw_i2c_prio prio,
+		       const struct i2c_client *client, const char *buf, int len);
+int jmw_i2c_sched_recv(struct jmw_i2c_sched *s, enum jmw_i2c_prio prio,
+		       const struct i2c_client *client, char *buf, int len);
+
+/*
+ * 변환 시작 후 fetch 시각 (ktime_get_ns 기준) 예약 / fetch 끝나면 해제
+ * 예약 중에는 그 시각을 넘길 DISPLAY 전송이 기다림
+ * 예약 칸은 하나 (버스당 SHT20 하나 기준), 나중 예약이 덮어씀
+ */
+void jmw_i2c_sched_reserve(struct jmw_i2c_sched *s, u64 at_ns);
+void jmw_i2c_sched_release(struct jmw_i2c_sched *s);
+
+#endif
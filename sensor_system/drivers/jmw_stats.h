@@ -0,0 +1,182 @@
+#ifndef JMW_STATS_H
+#define JMW_STATS_H
+
+#include <linux/kernel.h>
+#include <linux/percpu.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/fs.h>
+#include <linux/log2.h>
+#include <linux/irqflags.h>
+#include <linux/math64.h>
+
+/*
+ * 드라이버 공용 성능 카운터 (헤더만 있음 -> 모듈마다 자기 복사본, 모듈 간 의존성 없음)
+ *
+ * /sys/kernel/debug/<driver>[:<device>]/
+ *  stats   전송 횟수, 바이트, 에러(NACK 등), 재시도, 지연 min/avg/max, log2 히스토그램
+ *  reset   아무 값이나 쓰면 0으로
+ *
+ * CPU마다 따로 세고 읽을때만 합침 -> 갱신에 lock, 공유 cache line 없음
+ * hard IRQ (버튼, SPI 완료 콜백)에서도 부를 수 있음
+ */
+
+#define JMW_STATS_BUCKETS 32 // [2^k, 2^(k+1)) ns, 마지막 칸은 ~2s 이상 전부
+
+struct jmw_stats_cpu {
+	u64 xfers;
+	u64 bytes;
+	u64 errors;
+	u64 retries;
+	u64 lat_sum; // ns
+	u64 lat_min;
+	u64 lat_max;
+	u64 hist[JMW_STATS_BUCKETS];
+};
+
+struct jmw_stats {
+	struct jmw_stats_cpu __percpu *cpu;
+	struct dentry *dir;
+};
+
+/*
+ * 전송 하나 기록
+ * @bytes: 실제로 오간 바이트 (실패하면 세지 않음)
+ * @err: 음수면 에러
+ * @ns: 걸린 시간
+ */
+static inline void jmw_stats_add(struct jmw_stats *st, unsigned int bytes, int err, u64 ns) {
+	struct jmw_stats_cpu *c;
+	unsigned long flags;
+
+	// 같은 CPU의 IRQ가 끼어들어 같은 카운터를 갱신할 수 있음
+	local_irq_save(flags);
+	c = this_cpu_ptr(st->cpu);
+	c->xfers++;
+	if (err < 0)
+		c->errors++;
+	else
+		c->bytes += bytes;
+	c->lat_sum += ns;
+	c->lat_min = min(c->lat_min, ns);
+	c->lat_max = max(c->lat_max, ns);
+	c->hist[min_t(int, ns ? ilog2(ns) : 0, JMW_STATS_BUCKETS - 1)]++;
+	local_irq_restore(flags);
+}
+
+static inline void jmw_stats_retry(struct jmw_stats *st) {
+	this_cpu_inc(st->cpu->retries);
+}
+
+/*
+ * 다른 CPU가 갱신 중이면 그 전송 하나는 reset 전/후 어느쪽에 들어갈지 모름 (통계용이라 허용)
+ */
+static inline void jmw_stats_reset(struct jmw_stats *st) {
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		struct jmw_stats_cpu *c = per_cpu_ptr(st->cpu, cpu);
+
+		memset(c, 0, sizeof(*c));
+		c->lat_min = U64_MAX;
+	}
+}
+
+static inline void jmw_stats_sum(struct jmw_stats *st, struct jmw_stats_cpu *sum) {
+	int cpu;
+	int i;
+
+	memset(sum, 0, sizeof(*sum));
+	sum->lat_min = U64_MAX;
+	for_each_possible_cpu(cpu) {
+		struct jmw_stats_cpu *c = per_cpu_ptr(st->cpu, cpu);
+
+		sum->xfers += c->xfers;
+		sum->bytes += c->bytes;
+		sum->errors += c->errors;
+		sum->retries += c->retries;
+		sum->lat_sum += c->lat_sum;
+		sum->lat_min = min(sum->lat_min, c->lat_min);
+		sum->lat_max = max(sum->lat_max, c->lat_max);
+		for (i = 0; i < JMW_STATS_BUCKETS; i++)
+			sum->hist[i] += c->hist[i];
+	}
+}
+
+static inline int jmw_stats_show(struct seq_file *s, void *unused) {
+	struct jmw_stats_cpu sum;
+	int i;
+
+	jmw_stats_sum(s->private, &sum);
+
+	seq_printf(s, "xfers: %llu\n", sum.xfers);
+	seq_printf(s, "bytes: %llu\n", sum.bytes);
+	seq_printf(s, "errors: %llu\n", sum.errors);
+	seq_printf(s, "retries: %llu\n", sum.retries);
+	seq_printf(s, "lat_min_ns: %llu\n", sum.xfers ? sum.lat_min : 0);
+	seq_printf(s, "lat_avg_ns: %llu\n", sum.xfers ? div64_u64(sum.lat_sum, sum.xfers) : 0);
+	seq_printf(s, "lat_max_ns: %llu\n", sum.lat_max);
+
+	// 빈 칸은 생략
+	for (i = 0; i < JMW_STATS_BUCKETS; i++) {
+		if (sum.hist[i] == 0)
+			continue;
+		seq_printf(s, "hist_ns[%llu, %llu): %llu\n",
+			   i ? 1ULL << i : 0, 1ULL << (i + 1), sum.hist[i]);
+	}
+	return 0;
+}
+
+static inline int jmw_stats_open(struct inode *inode, struct file *file) {
+	return single_open(file, jmw_stats_show, inode->i_private);
+}
+
+static inline ssize_t jmw_stats_reset_write(struct file *file, const char __user *buf,
+					    size_t len, loff_t *pos) {
+	jmw_stats_reset(file_inode(file)->i_private);
+	return len;
+}
+
+static const struct file_operations jmw_stats_fops = {
+	.owner = THIS_MODULE,
+	.open = jmw_stats_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static const struct file_operations jmw_stats_reset_fops = {
+	.owner = THIS_MODULE,
+	.write = jmw_stats_reset_write,
+};
+
+/*
+ * @drv: debugfs 디렉토리 이름
+ * @dev: 같은 드라이버에 디바이스가 여럿이면 구분용 (dev_name), 없으면 NULL
+ * debugfs가 없거나 실패해도 카운터는 동작 (debugfs 에러는 무시하는게 커널 관례)
+ */
+static inline int jmw_stats_init(struct jmw_stats *st, const char *drv, const char *dev) {
+	char name[64];
+
+	st->cpu = alloc_percpu(struct jmw_stats_cpu);
+	if (st->cpu == NULL)
+		return -ENOMEM;
+	jmw_stats_reset(st);
+
+	if (dev != NULL)
+		snprintf(name, sizeof(name), "%s:%s", drv, dev);
+	else
+		snprintf(name, sizeof(name), "%s", drv);
+
+	st->dir = debugfs_create_dir(name, NULL);
+	debugfs_create_file("stats", 0444, st->dir, st, &jmw_stats_fops);
+	debugfs_create_file("reset", 0200, st->dir, st, &jmw_stats_reset_fops);
+	return 0;
+}
+
+static inline void jmw_stats_free(struct jmw_stats *st) {
+	debugfs_remove_recursive(st->dir); // 읽는 중인 파일이 끝날때까지 대기
+	free_percpu(st->cpu);
+}
+
+#endif
@@ -5,6 +5,10 @@
 #include <linux/device.h>
 #include <linux/uaccess.h>
 #include <linux/gpio.h>
+#include <linux/leds.h>
+
+#define CREATE_TRACE_POINTS
+#include "led_trace.h"
 
 #define DRIVER_NAME "LED_DRIVER"
 #define CLASS_NAME "LED_CLASS"
@@ -12,29 +16,83 @@
 #define LED1 531
 #define LED2 525
 
+/*
+ * LED class에 등록되는 LED
+ * default_trigger 이름은 sht20_driver, irq_btn_driver가 등록하는 trigger와 일치해야 함
+ * -> 드라이버 로드 순서와 상관없이 trigger가 등록되는 순간 자동으로 연결됨
+ * -> /sys/class/leds/<name>/trigger 로 런타임에 변경 가능
+ */
+struct jmw_led {
+	int gpio;
+	struct led_classdev cdev;
+};
+
 static dev_t led_dev_num;
 static struct cdev led_chr_dev;
 static struct class *led_class;
 static struct device *led_dev;
 
+static void jmw_led_set(struct led_classdev *cdev, enum led_brightness value);
+
+static struct jmw_led leds[] = {
+	{
+		.gpio = LED1,
+		.cdev = {
+			.name = "jmw:red:alarm",
+			.default_trigger = "sht20-over-threshold",
+			.max_brightness = 1,
+			.brightness_set = jmw_led_set,
+		},
+	},
+	{
+		.gpio = LED2,
+		.cdev = {
+			.name = "jmw:green:button",
+			.default_trigger = "button-pressed",
+			.max_brightness = 1,
+			.brightness_set = jmw_led_set,
+		},
+	},
+};
+
+/*
+ * LED class / trigger에서 호출됨
+ * trigger는 timer, hard IRQ 등 atomic context에서 부를 수 있으므로 sleep 하면 안됨
+ * -> Pi의 GPIO는 sleep 하지 않는 gpio_set_value로 충분
+ */
+static void jmw_led_set(struct led_classdev *cdev, enum led_brightness value) {
+	struct jmw_led *led = container_of(cdev, struct jmw_led, cdev);
+
+	gpio_set_value(led->gpio, value ? 1 : 0);
+	trace_jmw_led_state(cdev->name, led->gpio, value ? 1 : 0);
+}
+
 static ssize_t led_write(struct file *file, const char __user *buf, size_t len, loff_t *pos) {
 	char command;
+	enum led_brightness value;
+
+	if (copy_from_user(&command, buf, 1))
+		return -EFAULT;
 
-	copy_from_user(&command, buf, 1);
 	if (command == '1') {
-		gpio_set_value(LED1, 1);
-		gpio_set_value(LED2, 1);
-		printk(KERN_INFO "gpio set 1\n");
+		value = LED_ON;
 	}
 	else if (command == '0') {
-		gpio_set_value(LED1, 0);
-		gpio_set_value(LED2, 0);
-		printk(KERN_INFO "gpio set 0\n");
+		value = LED_OFF;
 	}
 	else {
 		printk(KERN_ERR "gpio set err\n");
-		return -1;
+		return -EINVAL;
 	}
+
+	/*
+	 * LED class를 거쳐서 설정 -> sysfs의 brightness와 상태가 일치
+	 * 드라이버 자체 상태가 없고 GPIO 한번 쓰기는 atomic -> lock 없음
+	 * writer가 동시에 오면 LED마다 마지막 값이 남음 (두 LED가 잠깐 달라질 수는 있음)
+	 */
+	for (int i = 0; i < ARRAY_SIZE(leds); i++)
+		led_set_brightness(&leds[i].cdev, value);
+
 	return 1;
 }
 
@@ -43,34 +101,44 @@ static const struct file_operations fops = {
 	.write = led_write,
 };
 
-
+static void led_unregister_all(int count) {
+	while (count-- > 0) {
+		led_classdev_unregister(&leds[count].cdev);
+		gpio_free(leds[count].gpio);
+	}
+}
 
 static int __init led_init(void) {
 	int ret;
-
-	ret = gpio_request_one(LED1, GPIOF_OUT_INIT_LOW, DEVICE_NAME);
-	if (ret != 0) {
-		printk(KERN_ERR "gpio request err\n");
-		return -1;
-	}
-
-	ret = gpio_request_one(LED2, GPIOF_OUT_INIT_LOW, DEVICE_NAME);
-	if (ret != 0) {
-		printk(KERN_ERR "gpio request err\n");
-		return -1;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(leds); i++) {
+		ret = gpio_request_one(leds[i].gpio, GPIOF_OUT_INIT_LOW, DEVICE_NAME);
+		if (ret != 0) {
+			printk(KERN_ERR "gpio request err\n");
+			goto err_led;
+		}
+
+		ret = led_classdev_register(NULL, &leds[i].cdev);
+		if (ret != 0) {
+			printk(KERN_ERR "led classdev register err\n");
+			gpio_free(leds[i].gpio);
+			goto err_led;
+		}
 	}
 
 	ret = alloc_chrdev_region(&led_dev_num, 0, 1, DRIVER_NAME);
 	if (ret != 0) {
 		printk(KERN_ERR "get device number err\n");
-		return -1;
+		goto err_led;
 	}
 
 	cdev_init(&led_chr_dev, &fops);
 	ret = cdev_add(&led_chr_dev, led_dev_num, 1);
 	if (ret < 0) {
 		printk(KERN_ERR "char device add err\n");
-		return -1;
+		unregister_chrdev_region(led_dev_num, 1);
+		goto err_led;
 	}
 
 	led_class = class_create(CLASS_NAME);
@@ -78,16 +146,20 @@ static int __init led_init(void) {
 
 	printk(KERN_INFO "init sucess\n");
 	return 0;
+
+err_led:
+	led_unregister_all(i);
+	return ret;
 }
 
 static void __exit led_exit(void) {
-	gpio_free(LED1); // gpio free
-	gpio_free(LED2);
-
 	device_destroy(led_class, led_dev_num);
 	class_destroy(led_class);
+	cdev_del(&led_chr_dev);
 
 	unregister_chrdev_region(led_dev_num, 1);
+
+	led_unregister_all(ARRAY_SIZE(leds)); // trigger 해제 후 gpio free
 }
 
 module_init(led_init);
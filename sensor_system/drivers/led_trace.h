@@ -0,0 +1,37 @@
+/*
+ * LED tracepoints
+ * /sys/kernel/tracing/events/jmw_led/
+ * trigger (hard IRQ, timer)에서도 불리므로 printk 대신 사용
+ */
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM jmw_led
+
+#if !defined(_LED_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _LED_TRACE_H
+
+#include <linux/tracepoint.h>
+
+/* LED 상태 변경 (char device write, sysfs brightness, trigger 모두 여기로) */
+TRACE_EVENT(jmw_led_state,
+	TP_PROTO(const char *name, int gpio, int value),
+	TP_ARGS(name, gpio, value),
+	TP_STRUCT__entry(
+		__array(char, name, 32)
+		__field(int, gpio)
+		__field(int, value)
+	),
+	TP_fast_assign(
+		strscpy(__entry->name, name, sizeof(__entry->name));
+		__entry->gpio = gpio;
+		__entry->value = value;
+	),
+	TP_printk("%s gpio=%d value=%d", __entry->name, __entry->gpio, __entry->value)
+);
+
+#endif /* _LED_TRACE_H */
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE led_trace
+#include <trace/define_trace.h>
@@ -0,0 +1,55 @@
+#ifndef SHT20_CONV_H
+#define SHT20_CONV_H
+
+#include <linux/types.h>
+
+/*
+ * SHT20 응답 디코딩 / 변환 (I2C, sleep 없는 순수 계산)
+ * sht20_driver, sim 모델, KUnit 등 하드웨어 없는 테스트에서 같이 사용
+ */
+
+/*
+ * 측정 명령 (드라이버, tracepoint에서 같이 사용)
+ * no hold master: 변환 중에는 버스를 놓고 있음 (read하면 NACK)
+ * hold master (0xE3/0xE5)는 clock stretching으로 버스를 잡음 + bcm2835 I2C는 stretching 지원이 불안정
+ */
+#define TEMP_MEASUREMENT 0xF3 // temp measurement command
+#define HUMID_MEASUREMENT 0xF5 // humid measurement command
+
+/*
+ * 측정 응답 3바이트 (MSB, LSB, CRC) -> raw
+ * LSB 하위 2비트는 stat비트이기 때문에 무시
+ */
+static inline int sht20_raw_ticks(const u8 *buf) {
+	return (buf[0] << 8) | (buf[1] & 0xFC);
+}
+
+/*
+ * raw 온도 -> m°C (고정 소수점)
+ * T = -46.85 + 175.72 * raw / 2^16
+ */
+static inline int sht20_temp_mc(int temp_raw) {
+	return -46850 + (int)((175720LL * temp_raw) >> 16);
+}
+
+/*
+ * raw 습도 -> m%RH
+ * RH = -6 + 125 * raw / 2^16
+ */
+static inline int sht20_humid_mpct(int humid_raw) {
+	return -6000 + (int)((125000LL * humid_raw) >> 16);
+}
+
+// CRC-8, 다항식 0x31 (x^8 + x^5 + x^4 + 1), 초기값 0 (데이터시트 5.7)
+static inline u8 sht20_crc8(const u8 *data, int len) {
+	u8 crc = 0;
+
+	for (int i = 0; i < len; i++) {
+		crc ^= data[i];
+		for (int bit = 0; bit < 8; bit++)
+			crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : crc << 1;
+	}
+	return crc;
+}
+
+#endif
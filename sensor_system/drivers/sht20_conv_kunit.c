@@ -0,0 +1,163 @@
+#include <kunit/test.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+
+#include "sht20_conv.h"
+
+/*
+ * sht20_conv.h KUnit 테스트 + 마이크로벤치마크
+ * CRC 예상값: 데이터시트 / Sensirion CRC 앱노트 예제
+ * 변환 예상값: 데이터시트 식을 double로 계산 후 고정 소수점 (>> 16) 결과와 맞춘 값
+ */
+
+#define BENCH_SAMPLES 1000000
+
+static void sht20_raw_ticks_test(struct kunit *test) {
+	static const struct {
+		u8 buf[3];
+		int raw;
+	} cases[] = {
+		{ { 0x63, 0x52, 0x00 }, 0x6350 }, // stat 비트 (0x02) 제거
+		{ { 0x63, 0x50, 0x00 }, 0x6350 },
+		{ { 0x00, 0x03, 0x00 }, 0x0000 }, // 하한: stat 비트만
+		{ { 0x00, 0x04, 0x00 }, 0x0004 },
+		{ { 0xFF, 0xFF, 0xFF }, 0xFFFC }, // 상한
+		{ { 0x80, 0x00, 0x00 }, 0x8000 }, // 부호 확장 없음
+	};
+
+	for (int i = 0; i < ARRAY_SIZE(cases); i++)
+		KUNIT_EXPECT_EQ_MSG(test, sht20_raw_ticks(cases[i].buf), cases[i].raw, "case %d", i);
+}
+
+static void sht20_temp_mc_test(struct kunit *test) {
+	static const int cases[][2] = {
+		{ 0, -46850 },
+		{ 1, -46848 },
+		{ 17472, -3 }, // 0°C 경계 아래
+		{ 17473, -1 },
+		{ 17474, 2 }, // 0°C 경계 위
+		{ 0x6350, 21318 }, // 21.318°C
+		{ 0xFFFC, 128859 }, // 측정으로 나올 수 있는 최대
+		{ 0xFFFF, 128867 },
+	};
+
+	for (int i = 0; i < ARRAY_SIZE(cases); i++)
+		KUNIT_EXPECT_EQ_MSG(test, sht20_temp_mc(cases[i][0]), cases[i][1], "raw %d", cases[i][0]);
+}
+
+static void sht20_humid_mpct_test(struct kunit *test) {
+	static const int cases[][2] = {
+		{ 0, -6000 },
+		{ 1, -5999 },
+		{ 3145, -2 }, // 0 %RH 경계 아래
+		{ 3146, 0 },
+		{ 3147, 2 },
+		{ 0x7C80, 54791 },
+		{ 0xFFFC, 118992 },
+		{ 0xFFFF, 118998 },
+	};
+
+	for (int i = 0; i < ARRAY_SIZE(cases); i++)
+		KUNIT_EXPECT_EQ_MSG(test, sht20_humid_mpct(cases[i][0]), cases[i][1], "raw %d", cases[i][0]);
+}
+
+// 단조 증가: 변환 순서를 바꾸는 최적화가 tick 사이 값을 뒤집지 않는지
+static void sht20_conv_monotonic_test(struct kunit *test) {
+	for (int raw = 1; raw <= 0xFFFF; raw++) {
+		KUNIT_ASSERT_LE(test, sht20_temp_mc(raw - 1), sht20_temp_mc(raw));
+		KUNIT_ASSERT_LE(test, sht20_humid_mpct(raw - 1), sht20_humid_mpct(raw));
+	}
+}
+
+static void sht20_crc8_test(struct kunit *test) {
+	static const u8 one[] = { 0xDC };
+	static const u8 temp[] = { 0x68, 0x3A };
+	static const u8 humid[] = { 0x4E, 0x85 };
+	static const u8 zero[] = { 0x00, 0x00 };
+	static const u8 ones[] = { 0xFF, 0xFF };
+	u8 resp[3] = { 0x68, 0x3A, 0x7C };
+
+	KUNIT_EXPECT_EQ(test, sht20_crc8(one, 1), 0x79);
+	KUNIT_EXPECT_EQ(test, sht20_crc8(temp, 2), 0x7C);
+	KUNIT_EXPECT_EQ(test, sht20_crc8(humid, 2), 0x6B);
+	KUNIT_EXPECT_EQ(test, sht20_crc8(zero, 2), 0x00);
+	KUNIT_EXPECT_EQ(test, sht20_crc8(ones, 2), 0x2D);
+	KUNIT_EXPECT_EQ(test, sht20_crc8(NULL, 0), 0x00);
+
+	// 응답 3바이트 전체의 CRC는 0, 한 비트라도 틀리면 0이 아님
+	KUNIT_EXPECT_EQ(test, sht20_crc8(resp, 3), 0x00);
+	for (int bit = 0; bit < 24; bit++) {
+		resp[bit / 8] ^= 1 << (bit % 8);
+		KUNIT_EXPECT_NE_MSG(test, sht20_crc8(resp, 3), 0x00, "bit %d", bit);
+		resp[bit / 8] ^= 1 << (bit % 8);
+	}
+}
+
+static struct kunit_case sht20_conv_cases[] = {
+	KUNIT_CASE(sht20_raw_ticks_test),
+	KUNIT_CASE(sht20_temp_mc_test),
+	KUNIT_CASE(sht20_humid_mpct_test),
+	KUNIT_CASE(sht20_conv_monotonic_test),
+	KUNIT_CASE(sht20_crc8_test),
+	{}
+};
+
+static struct kunit_suite sht20_conv_suite = {
+	.name = "sht20_conv",
+	.test_cases = sht20_conv_cases,
+};
+
+/*
+ * 벤치마크: read() 한번 = 응답 두개 (CRC 확인 + tick + 변환)
+ */
+static void sht20_decode_bench(struct kunit *test) {
+	u8 buf[3] = { 0x68, 0x3A, 0x7C };
+	long long sum = 0;
+	u64 t0, ns;
+
+	t0 = ktime_get_ns();
+	for (int i = 0; i < BENCH_SAMPLES; i++) {
+		OPTIMIZER_HIDE_VAR(buf[1]);
+		if (sht20_crc8(buf, 3) == 0)
+			sum += sht20_temp_mc(sht20_raw_ticks(buf)) + sht20_humid_mpct(sht20_raw_ticks(buf));
+	}
+	ns = ktime_get_ns() - t0;
+
+	kunit_info(test, "crc8 + ticks + convert: %d samples in %llu us (%llu ns/sample, sum %lld)\n",
+		   BENCH_SAMPLES, div_u64(ns, NSEC_PER_USEC), div_u64(ns, BENCH_SAMPLES), sum);
+	KUNIT_EXPECT_NE(test, sum, 0LL);
+}
+
+static void sht20_crc8_bench(struct kunit *test) {
+	u8 buf[2] = { 0x68, 0x3A };
+	unsigned int acc = 0;
+	u64 t0, ns;
+
+	t0 = ktime_get_ns();
+	for (int i = 0; i < BENCH_SAMPLES; i++) {
+		buf[1] = i;
+		OPTIMIZER_HIDE_VAR(buf[0]);
+		acc += sht20_crc8(buf, 2);
+	}
+	ns = ktime_get_ns() - t0;
+
+	kunit_info(test, "crc8 (2 bytes): %d in %llu us (%llu ps/call, acc %u)\n",
+		   BENCH_SAMPLES, div_u64(ns, NSEC_PER_USEC), div_u64(ns * 1000, BENCH_SAMPLES), acc);
+	KUNIT_EXPECT_GT(test, ns, 0ULL);
+}
+
+static struct kunit_case sht20_conv_bench_cases[] = {
+	KUNIT_CASE(sht20_decode_bench),
+	KUNIT_CASE(sht20_crc8_bench),
+	{}
+};
+
+static struct kunit_suite sht20_conv_bench_suite = {
+	.name = "sht20_conv_bench",
+	.test_cases = sht20_conv_bench_cases,
+};
+
+kunit_test_suites(&sht20_conv_suite, &sht20_conv_bench_suite);
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("KUnit tests for the SHT20 response decoding and conversion");
@@ -10,18 +10,76 @@
 #include <linux/device.h>
 #include <linux/uaccess.h>
 #include <linux/delay.h>
+#include <linux/mutex.h>
+#include <linux/workqueue.h>
+#include <linux/leds.h>
+#include <linux/wait.h>
+#include <linux/poll.h>
+#include <linux/ktime.h>
+#include <linux/list.h>
+#include <linux/kref.h>
+#include <linux/completion.h>
+#include <linux/notifier.h>
+#include <linux/string.h>
+
+#include "jmw_stats.h"
+#include "jmw_export.h"
+#include "jmw_i2c_sched.h"
+#include "sht20_conv.h"
+
+#define CREATE_TRACE_POINTS
+#include "sht20_trace.h"
 
 #define DRIVER_NAME "sht20_driver"
 #define DEVICE_COUNT 1
 #define CLASS_NAME "sht20_class"
 #define DEVICE_NAME "sht20_device"
 
-#define TEMP_MEASUREMENT 0xE3 // temp measurement command
-#define HUMID_MEASUREMENT 0xE5 // humid measurement command
+// TEMP_MEASUREMENT, HUMID_MEASUREMENT: sht20_conv.h (tracepoint도 같이 사용)
 #define WRITE_USER_REGISTER 0xE6
 #define READ_USER_REGISTER 0xE7
 #define SOFT_RESET 0xFE // soft reset command
 
+/* 데이터시트 최대 시간 (기본 해상도 RH 12bit / T 14bit) */
+#define SOFT_RESET_MS 15
+#define TEMP_MEASURE_MS 85
+#define HUMID_MEASURE_MS 29
+#define FETCH_RETRY_MS 2 // 최대 시간이 지났는데 아직 NACK
+#define FETCH_RETRIES 3
+
+#define ALARM_TRIGGER_NAME "sht20-over-threshold"
+
+/*
+ * 온도 경보 (LED trigger)
+ * @temp_threshold: 이 온도(m°C) 이상이면 trigger ON
+ * @temp_hysteresis: threshold - hysteresis 미만으로 내려가야 OFF (경계에서 깜빡임 방지)
+ * @alarm_poll_ms: 커널에서 주기적으로 온도 측정하는 주기, 0이면 read()때만 갱신
+ */
+static int temp_threshold = 30000;
+module_param(temp_threshold, int, 0644);
+MODULE_PARM_DESC(temp_threshold, "over-threshold trigger level in milli-degC");
+
+static int temp_hysteresis = 500;
+module_param(temp_hysteresis, int, 0644);
+MODULE_PARM_DESC(temp_hysteresis, "trigger release hysteresis in milli-degC");
+
+static unsigned int alarm_poll_ms = 5000;
+module_param(alarm_poll_ms, uint, 0644);
+MODULE_PARM_DESC(alarm_poll_ms, "in-kernel temperature poll period for the trigger (0 = only on read)");
+
+DEFINE_LED_TRIGGER(sht20_alarm_trigger);
+
+/*
+ * 초기화 상태
+ * probe는 char device만 만들고 바로 반환, soft reset은 init_work에서
+ * 유저는 poll(POLLIN)로 준비 완료를 기다림
+ */
+enum sht20_state {
+	SHT20_INIT,
+	SHT20_READY,
+	SHT20_FAILED,
+};
+
 static struct sht20_device {
 	struct i2c_client *client; // i2c에 연결된 칩 인식
 	dev_t dev_num;
@@ -29,8 +87,32 @@ static struct sht20_device {
 	struct class *class;
 	int temp;
 	int humid;
+
+	struct mutex lock; // 측정 명령 -> 수신 순서 보호 (read()와 alarm_work가 동시에 버스 사용)
+	struct delayed_work alarm_work;
+	bool alarm;
+
+	struct work_struct init_work;
+	enum sht20_state state;
+	wait_queue_head_t wq; // 초기화 끝나길 기다리는 read / poll
+
+	struct jmw_stats stats; // 측정 단위 (명령 1byte + 수신 3byte), debugfs sht20:<i2c dev>
+	struct jmw_i2c_sched *sched; // 같은 adapter의 LCD와 공유
+	struct list_head node; // sht20_list (sht20_measure에서 이름으로 찾음)
+	struct kref ref; // 목록 1 + 측정 중인 sht20_measure 마다 1 + 열린 파일마다 1
+	struct completion released; // ref가 0 -> remove 진행
 };
 
+/*
+ * sht20_measure()용 인스턴스 목록
+ * lock은 찾고 ref 잡는 동안만 -> 측정 (~100ms)과 notifier는 lock 없이
+ * remove는 목록에서 빼고 자기 ref를 놓은 뒤 측정 중인 호출이 다 끝날때까지 기다림
+ */
+static LIST_HEAD(sht20_list);
+static DEFINE_MUTEX(sht20_list_lock);
+
+static BLOCKING_NOTIFIER_HEAD(sht20_notifier);
+
 // 연관된 dtbo file을 찾기위함
 static const struct of_device_id sht20_ids[] = {
 	{.compatible = "jmw,sht20"}, // .dts와 일치
@@ -38,17 +120,33 @@ static const struct of_device_id sht20_ids[] = {
 };
 MODULE_DEVICE_TABLE(of, sht20_ids);
 
+// DT 없이 이름으로 붙일때 (sensor_system/sim의 가짜 adapter, i2c new_device)
+static const struct i2c_device_id sht20_id[] = {
+	{"sht20", 0},
+	{},
+};
+MODULE_DEVICE_TABLE(i2c, sht20_id);
+
 /*
  * Do soft reset
  * @client: target device(SHT20)
  */
 static int sht20_soft_reset(struct i2c_client *client) {
-	int ret = i2c_smbus_write_byte(client, SOFT_RESET); // write SOFT_RESET command to SHT20
+	struct sht20_device *sht20 = i2c_get_clientdata(client);
+	u64 t0 = ktime_get_ns();
+	int ret;
+
+	u8 cmd = SOFT_RESET;
+
+	trace_sht20_i2c_cmd(client->addr, SOFT_RESET);
+	ret = jmw_i2c_sched_send(sht20->sched, JMW_I2C_PRIO_SENSOR, client, &cmd, 1); // write SOFT_RESET command to SHT20
+	trace_sht20_i2c_done(client->addr, SOFT_RESET, ret);
+	jmw_stats_add(&sht20->stats, 1, ret, ktime_get_ns() - t0);
 	if (ret < 0) {
 		printk(KERN_ERR "i2c smbus write fail\n");
 		return -1;
 	}
-	msleep(100);
+	msleep(SOFT_RESET_MS);
 
 	return ret;
 }
@@ -56,44 +154,166 @@ static int sht20_soft_reset(struct i2c_client *client) {
 /*
  * Read data from SHT20
  * @client: target device(SHT20): client->addr (chip address: 0x40)
- * @command: TEMP_MEASUREMENT = 0xE3
- * 			 HUMID_MEASUREMENT = 0xE5
+ * @command: TEMP_MEASUREMENT = 0xF3
+ * 			 HUMID_MEASUREMENT = 0xF5
  * @val: variable to store the read value
+ *
+ * 명령 -> fetch 시각 예약 -> 변환 시간만큼 sleep (그동안 LCD 전송) -> fetch
+ * fetch는 SENSOR 우선순위라 LCD 바이트 하나 이상 기다리지 않음
  */
 static int sht20_read_data(struct i2c_client *client, int command, int *val) {
+	struct sht20_device *sht20 = i2c_get_clientdata(client);
+	unsigned int conv_us = (command == TEMP_MEASUREMENT ? TEMP_MEASURE_MS : HUMID_MEASURE_MS) * USEC_PER_MSEC;
+	u64 t0 = ktime_get_ns();
+	u8 cmd = command;
 	int ret;
 	u8 buf[3]; // 데이터 받을 unsigned char 3byte
 
-	ret = i2c_smbus_write_byte(client, command); // write command to sht20
+	trace_sht20_measure_start(command);
+
+	trace_sht20_i2c_cmd(client->addr, command);
+	ret = jmw_i2c_sched_send(sht20->sched, JMW_I2C_PRIO_SENSOR, client, &cmd, 1); // write command to sht20
+	trace_sht20_i2c_done(client->addr, command, ret);
 	if (ret < 0) {
-		printk(KERN_ERR "i2c_smbus_write_byte Fail\n");
+		printk(KERN_ERR "i2c command send Fail\n");
+		trace_sht20_measure_end(command, 0, ret);
+		jmw_stats_add(&sht20->stats, 0, ret, ktime_get_ns() - t0);
 		return -1;
 	}
 
-	msleep(100);
+	jmw_i2c_sched_reserve(sht20->sched, ktime_get_ns() + (u64)conv_us * NSEC_PER_USEC);
+	usleep_range(conv_us, conv_us + 200); // msleep은 jiffy 단위로 늦음 -> 예약 시각에 맞춰 깨어남
+
+	for (int i = 0; ; i++) {
+		ret = jmw_i2c_sched_recv(sht20->sched, JMW_I2C_PRIO_SENSOR, client, buf, 3); // SHT20으로부터 word만큼 데이터 읽음(3byte)
+		if (ret >= 0 || i == FETCH_RETRIES)
+			break;
+		jmw_stats_retry(&sht20->stats); // 아직 변환 중 (NACK)
+		msleep(FETCH_RETRY_MS);
+	}
+	jmw_i2c_sched_release(sht20->sched);
 
-	ret = i2c_master_recv(client, buf, 3); // SHT20으로부터 word만큼 데이터 읽음(3byte)
 	if (ret < 0) {
 		printk(KERN_ERR "i2c_master_recv Fail\n");
+		trace_sht20_measure_end(command, 0, ret);
+		jmw_stats_add(&sht20->stats, 1, ret, ktime_get_ns() - t0);
 		return -1;
 	}
 	
-	*val = (buf[0] << 8) | (buf[1] & 0xFC); // buf[1]에서 하위 2비트는 stat비트이기 때문에 무시
+	*val = sht20_raw_ticks(buf); // buf[1]에서 하위 2비트는 stat비트이기 때문에 무시
+	trace_sht20_measure_end(command, *val, 0);
+	jmw_stats_add(&sht20->stats, 4, 0, ktime_get_ns() - t0);
+
+	return 0;
+}
+
+/*
+ * 측정값으로 over-threshold trigger 상태 갱신
+ * 상태가 바뀔때만 led_trigger_event 호출
+ * @sht20->lock 잡은 상태에서 호출
+ */
+static void sht20_update_alarm(struct sht20_device *sht20, int temp_raw) {
+	int temp_mc = sht20_temp_mc(temp_raw);
+
+	if (!sht20->alarm && temp_mc >= temp_threshold) {
+		sht20->alarm = true;
+		led_trigger_event(sht20_alarm_trigger, LED_FULL);
+	}
+	else if (sht20->alarm && temp_mc < temp_threshold - temp_hysteresis) {
+		sht20->alarm = false;
+		led_trigger_event(sht20_alarm_trigger, LED_OFF);
+	}
+}
 
+/*
+ * 유저 프로세스 없이 온도를 주기적으로 측정해서 trigger 갱신
+ */
+static void sht20_alarm_work(struct work_struct *work) {
+	struct sht20_device *sht20 = container_of(to_delayed_work(work), struct sht20_device, alarm_work);
+	int temp_raw;
+
+	mutex_lock(&sht20->lock);
+	if (sht20_read_data(sht20->client, TEMP_MEASUREMENT, &temp_raw) == 0) {
+		sht20->temp = temp_raw;
+		sht20_update_alarm(sht20, temp_raw);
+	}
+	mutex_unlock(&sht20->lock);
+
+	if (alarm_poll_ms)
+		schedule_delayed_work(&sht20->alarm_work, msecs_to_jiffies(alarm_poll_ms));
+}
+
+/*
+ * 초기화 끝날때까지 대기
+ * @return: 0 준비 완료, -EAGAIN (O_NONBLOCK), -EIO 초기화 실패, 시그널
+ */
+static int sht20_wait_ready(struct sht20_device *sht20, struct file *file) {
+	int ret;
+
+	if (READ_ONCE(sht20->state) == SHT20_INIT && (file->f_flags & O_NONBLOCK))
+		return -EAGAIN;
+
+	ret = wait_event_interruptible(sht20->wq, READ_ONCE(sht20->state) != SHT20_INIT);
+	if (ret)
+		return ret;
+
+	return READ_ONCE(sht20->state) == SHT20_READY ? 0 : -EIO;
+}
+
+/*
+ * 온도 -> 습도 한 묶음 측정, 캐시 / 경보 갱신
+ * @sht20->lock 잡은 상태에서 호출
+ */
+static int sht20_measure_locked(struct sht20_device *sht20, int *temp_raw, int *humid_raw) {
+	int ret;
+
+	ret = sht20_read_data(sht20->client, TEMP_MEASUREMENT, temp_raw); // 0x40 chip address를 대상으로 온도 측정 명령
+	if (ret < 0) {
+		printk(KERN_ERR "Temp measurement fail\n");
+		return -1;
+	}
+
+	ret = sht20_read_data(sht20->client, HUMID_MEASUREMENT, humid_raw); // 0x40 chip address를 대상으로 습고 측정 명령
+	if (ret < 0) {
+		printk(KERN_ERR "Humid measurement fail\n");
+		return -1;
+	}
+
+	sht20->temp = *temp_raw;
+	sht20->humid = *humid_raw;
+	sht20_update_alarm(sht20, *temp_raw);
 	return 0;
 }
 
+/*
+ * 새 sample을 커널 안의 구독자 (jmw_bind)에게, lock 없이 호출
+ * -> 구독자가 다시 sht20_measure를 불러도 됨
+ */
+static void sht20_notify(struct sht20_device *sht20, int temp_raw, int humid_raw, struct sht20_sample *out) {
+	out->dev = dev_name(&sht20->client->dev);
+	out->temp_mc = sht20_temp_mc(temp_raw);
+	out->humid_mpct = sht20_humid_mpct(humid_raw);
+	out->ts_ns = ktime_get_ns();
+	blocking_notifier_call_chain(&sht20_notifier, 0, out);
+}
+
 /*
  * 유저가 read했을때 이 함수가 실행
+ *
+ * 락 규칙
+ *  - lock (mutex): 측정 명령 -> 변환 대기 -> 수신 한 묶음 + temp/humid/alarm 갱신
+ *    read(), alarm_work, init_work (soft reset) 모두 잡음, 센서 하나에 측정은 한번에 하나
+ *  - 안에서 I2C 전송과 변환 대기 (최대 ~85ms)로 sleep -> process context 전용, spinlock 안에서 호출 X
+ *  - 대기 중인 reader는 시그널로 빠져나올 수 있게 mutex_lock_interruptible
+ *  - copy_to_user는 lock 밖에서 (page fault로 sleep 가능, 그동안 버스를 잡고 있지 않도록)
  */
 static ssize_t sht20_read(struct file *file, char __user *buf, size_t len, loff_t *pos) {
 	struct sht20_device *sht20 = file->private_data;
+	struct sht20_sample sample;
 	int temp_raw;
 	int humid_raw;
 	char kbuf[64];
 
-	printk(KERN_INFO "sht20 read\n");
-
 	if (*pos > 0) {
 		printk(KERN_ERR "pos err\n");
 		return -1;
@@ -101,40 +321,154 @@ static ssize_t sht20_read(struct file *file, char __user *buf, size_t len, loff_
 
 	int ret;
 
-	ret = sht20_read_data(sht20->client, TEMP_MEASUREMENT, &temp_raw); // 0x40 chip address를 대상으로 온도 측정 명령
-	if (ret < 0) {
-		printk(KERN_ERR "Temp measurement fail\n");
-		return -1;
-	}
+	ret = sht20_wait_ready(sht20, file);
+	if (ret < 0)
+		return ret;
 
-	ret = sht20_read_data(sht20->client, HUMID_MEASUREMENT, &humid_raw); // 0x40 chip address를 대상으로 습고 측정 명령
-	if (ret < 0) {
-		printk(KERN_ERR "Humid measurement fail\n");
+	ret = mutex_lock_interruptible(&sht20->lock);
+	if (ret)
+		return ret;
+
+	ret = sht20_measure_locked(sht20, &temp_raw, &humid_raw);
+	mutex_unlock(&sht20->lock);
+	if (ret < 0)
 		return -1;
-	}
+
+	sht20_notify(sht20, temp_raw, humid_raw, &sample);
 
 	len = snprintf(kbuf, sizeof(kbuf), "%d|%d", temp_raw, humid_raw);
-	printk(KERN_INFO "%s\n", kbuf);
 
-	copy_to_user(buf, kbuf, len);
+	if (copy_to_user(buf, kbuf, len))
+		return -EFAULT;
 
 	return len;
 }
 
+static void sht20_release(struct kref *ref) {
+	struct sht20_device *sht20 = container_of(ref, struct sht20_device, ref);
+
+	complete(&sht20->released);
+}
+
+// 이름으로 찾아서 ref 잡기 (없으면 NULL), 다 쓰면 kref_put
+static struct sht20_device *sht20_get(const char *dev) {
+	struct sht20_device *sht20;
+
+	mutex_lock(&sht20_list_lock);
+	list_for_each_entry(sht20, &sht20_list, node) {
+		if (strcmp(dev_name(&sht20->client->dev), dev) == 0) {
+			kref_get(&sht20->ref);
+			mutex_unlock(&sht20_list_lock);
+			return sht20;
+		}
+	}
+	mutex_unlock(&sht20_list_lock);
+
+	return NULL;
+}
+
+int sht20_measure(const char *dev, struct sht20_sample *out) {
+	struct sht20_device *sht20 = sht20_get(dev);
+	int temp_raw;
+	int humid_raw;
+	int ret;
+
+	if (sht20 == NULL)
+		return -ENODEV;
+
+	if (READ_ONCE(sht20->state) != SHT20_READY) {
+		ret = READ_ONCE(sht20->state) == SHT20_INIT ? -EAGAIN : -EIO;
+		goto out;
+	}
+
+	mutex_lock(&sht20->lock);
+	ret = sht20_measure_locked(sht20, &temp_raw, &humid_raw) < 0 ? -EIO : 0;
+	mutex_unlock(&sht20->lock);
+	if (ret == 0)
+		sht20_notify(sht20, temp_raw, humid_raw, out);
+out:
+	kref_put(&sht20->ref, sht20_release);
+
+	return ret;
+}
+EXPORT_SYMBOL_GPL(sht20_measure);
+
+int sht20_register_notifier(struct notifier_block *nb) {
+	return blocking_notifier_chain_register(&sht20_notifier, nb);
+}
+EXPORT_SYMBOL_GPL(sht20_register_notifier);
+
+int sht20_unregister_notifier(struct notifier_block *nb) {
+	return blocking_notifier_chain_unregister(&sht20_notifier, nb);
+}
+EXPORT_SYMBOL_GPL(sht20_unregister_notifier);
+
+/*
+ * 열린 파일마다 ref -> read 중에 remove가 sched, stats를 해제하지 않음
+ * (remove는 파일이 모두 닫힐때까지 기다림)
+ */
 static int sht20_open(struct inode *inode, struct file *file) {
 	struct sht20_device *sht20;
 	sht20 = container_of(inode->i_cdev, struct sht20_device, sht20_cdev);
+	if (!kref_get_unless_zero(&sht20->ref)) // remove 진행 중
+		return -ENODEV;
 	file->private_data = sht20; // 센서 데이터에 접근가능 ex)temp
 	
 	return 0;
 }
 
+static int sht20_close(struct inode *inode, struct file *file) {
+	struct sht20_device *sht20 = file->private_data;
+
+	kref_put(&sht20->ref, sht20_release);
+	return 0;
+}
+
+/*
+ * 초기화가 끝나면 readable (read는 측정 시간만큼 block), 실패하면 EPOLLERR
+ */
+static __poll_t sht20_poll(struct file *file, poll_table *wait) {
+	struct sht20_device *sht20 = file->private_data;
+
+	poll_wait(file, &sht20->wq, wait);
+
+	switch (READ_ONCE(sht20->state)) {
+	case SHT20_READY:
+		return EPOLLIN | EPOLLRDNORM;
+	case SHT20_FAILED:
+		return EPOLLERR;
+	default:
+		return 0;
+	}
+}
+
 static const struct file_operations fops = {
 	.owner = THIS_MODULE,
 	.read = sht20_read,
 	.open = sht20_open,
+	.release = sht20_close,
+	.poll = sht20_poll,
 };
 
+/*
+ * soft reset (15ms)을 probe 밖에서 실행, 끝나면 경보 측정 시작
+ */
+static void sht20_init_work(struct work_struct *work) {
+	struct sht20_device *sht20 = container_of(work, struct sht20_device, init_work);
+
+	mutex_lock(&sht20->lock);
+	if (sht20_soft_reset(sht20->client) < 0) {
+		WRITE_ONCE(sht20->state, SHT20_FAILED);
+	} else {
+		WRITE_ONCE(sht20->state, SHT20_READY);
+		if (alarm_poll_ms)
+			schedule_delayed_work(&sht20->alarm_work, 0);
+	}
+	mutex_unlock(&sht20->lock);
+
+	wake_up_interruptible(&sht20->wq);
+}
+
 
 static int sht20_probe(struct i2c_client *client) {
 	struct sht20_device *sht20;
@@ -147,6 +481,21 @@ static int sht20_probe(struct i2c_client *client) {
 	}
 
 	sht20->client = client; // 실제 칩을 연결(client)
+	mutex_init(&sht20->lock);
+	INIT_DELAYED_WORK(&sht20->alarm_work, sht20_alarm_work);
+	INIT_WORK(&sht20->init_work, sht20_init_work);
+	init_waitqueue_head(&sht20->wq);
+	sht20->state = SHT20_INIT;
+
+	ret = jmw_stats_init(&sht20->stats, "sht20", dev_name(&client->dev));
+	if (ret < 0)
+		return ret;
+
+	sht20->sched = jmw_i2c_sched_get(client->adapter);
+	if (sht20->sched == NULL) {
+		jmw_stats_free(&sht20->stats);
+		return -ENOMEM;
+	}
 	
 	/*
 	 * @client: i2c_client구조체안에 dev가 존재, 그 dev안에 driver_data
@@ -154,14 +503,12 @@ static int sht20_probe(struct i2c_client *client) {
 	 */
 	i2c_set_clientdata(client, sht20); // 종료되어도 sht20의 상태를 알 수 있음
 
-	ret = sht20_soft_reset(client); // soft reset 명령 write
-	if (ret < 0)
-		return ret;
-
 	// create char dev, device, class
 	ret = alloc_chrdev_region(&(sht20->dev_num), 0, 1, DEVICE_NAME);
 	if (ret != 0) {
 		printk(KERN_ERR "alloc chrdev region fail\n");
+		jmw_i2c_sched_put(sht20->sched);
+		jmw_stats_free(&sht20->stats);
 		return -1;
 	}
 
@@ -169,22 +516,48 @@ static int sht20_probe(struct i2c_client *client) {
 	ret = cdev_add(&(sht20->sht20_cdev), sht20->dev_num, DEVICE_COUNT);
 	if (ret < 0) {
 		printk(KERN_ERR "cdev add fail\n");
+		jmw_i2c_sched_put(sht20->sched);
+		jmw_stats_free(&sht20->stats);
 		return -1;
 	}
 
 	sht20->class = class_create(CLASS_NAME);
 	device_create(sht20->class, NULL, sht20->dev_num, NULL, DEVICE_NAME);
 
+	kref_init(&sht20->ref);
+	init_completion(&sht20->released);
+	mutex_lock(&sht20_list_lock);
+	list_add_tail(&sht20->node, &sht20_list);
+	mutex_unlock(&sht20_list_lock);
+
+	schedule_work(&sht20->init_work); // soft reset, 끝나면 poll로 알림
+
 	return 0;
 }
 
 static void sht20_remove(struct i2c_client *client) {
 	struct sht20_device *sht20 = i2c_get_clientdata(client);
 
+	// 새로 open 못하게 먼저 내림
 	device_destroy(sht20->class, sht20->dev_num);
 	class_destroy(sht20->class);
 	cdev_del(&(sht20->sht20_cdev));
+
+	// 이후로는 못 찾게 하고, 진행 중인 sht20_measure, 열린 파일이 끝나길 기다림 (sched, stats 사용 중)
+	mutex_lock(&sht20_list_lock);
+	list_del(&sht20->node);
+	mutex_unlock(&sht20_list_lock);
+	kref_put(&sht20->ref, sht20_release);
+	wait_for_completion(&sht20->released);
+
+	cancel_work_sync(&sht20->init_work); // init_work가 alarm_work를 예약하므로 먼저
+	cancel_delayed_work_sync(&sht20->alarm_work);
+	if (sht20->alarm) // trigger는 모듈 전체가 같이 씀 (sht20_init)
+		led_trigger_event(sht20_alarm_trigger, LED_OFF);
+
 	unregister_chrdev_region(sht20->dev_num, 1);
+	jmw_stats_free(&sht20->stats);
+	jmw_i2c_sched_put(sht20->sched);
 
 	return;
 }
@@ -193,12 +566,37 @@ static struct i2c_driver sht20_driver = {
 	.driver = {
 		.name = "jmw_sht20",
 		.of_match_table = sht20_ids,
+		.probe_type = PROBE_PREFER_ASYNCHRONOUS,
 	},
+	.id_table = sht20_id,
 	.probe = sht20_probe,
 	.remove = sht20_remove,
 };
 
-module_i2c_driver(sht20_driver);
+static int __init sht20_init(void) {
+	int ret;
+
+	// 장치 수와 상관없이 trigger는 하나 (같은 이름 두번 등록 불가)
+	// default_trigger가 "sht20-over-threshold"인 LED가 자동으로 연결됨
+	led_trigger_register_simple(ALARM_TRIGGER_NAME, &sht20_alarm_trigger);
+
+	ret = i2c_add_driver(&sht20_driver);
+	if (ret < 0) {
+		printk(KERN_ERR "i2c add driver fail\n");
+		led_trigger_unregister_simple(sht20_alarm_trigger);
+		return ret;
+	}
+
+	return 0;
+}
+
+static void __exit sht20_exit(void) {
+	i2c_del_driver(&sht20_driver);
+	led_trigger_unregister_simple(sht20_alarm_trigger);
+}
+
+module_init(sht20_init);
+module_exit(sht20_exit);
 
 MODULE_LICENSE("GPL");
 MODULE_AUTHOR("JIN MINU");
@@ -0,0 +1,83 @@
+/*
+ * SHT20 tracepoints
+ * /sys/kernel/tracing/events/sht20/
+ * 꺼져 있으면 비용 거의 0 (static key) -> printk 대신 사용
+ */
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM sht20
+
+#if !defined(_SHT20_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _SHT20_TRACE_H
+
+#include <linux/tracepoint.h>
+
+#include "sht20_conv.h" // TEMP_MEASUREMENT
+
+/* I2C 명령 1바이트 전송 (측정 명령, soft reset) */
+TRACE_EVENT(sht20_i2c_cmd,
+	TP_PROTO(u16 addr, u8 cmd),
+	TP_ARGS(addr, cmd),
+	TP_STRUCT__entry(
+		__field(u16, addr)
+		__field(u8, cmd)
+	),
+	TP_fast_assign(
+		__entry->addr = addr;
+		__entry->cmd = cmd;
+	),
+	TP_printk("addr=0x%02x cmd=0x%02x", __entry->addr, __entry->cmd)
+);
+
+TRACE_EVENT(sht20_i2c_done,
+	TP_PROTO(u16 addr, u8 cmd, int ret),
+	TP_ARGS(addr, cmd, ret),
+	TP_STRUCT__entry(
+		__field(u16, addr)
+		__field(u8, cmd)
+		__field(int, ret)
+	),
+	TP_fast_assign(
+		__entry->addr = addr;
+		__entry->cmd = cmd;
+		__entry->ret = ret;
+	),
+	TP_printk("addr=0x%02x cmd=0x%02x ret=%d", __entry->addr, __entry->cmd, __entry->ret)
+);
+
+/* 측정 하나 (명령 -> 변환 대기 -> 3바이트 수신) */
+TRACE_EVENT(sht20_measure_start,
+	TP_PROTO(u8 cmd),
+	TP_ARGS(cmd),
+	TP_STRUCT__entry(
+		__field(u8, cmd)
+	),
+	TP_fast_assign(
+		__entry->cmd = cmd;
+	),
+	TP_printk("%s", __entry->cmd == TEMP_MEASUREMENT ? "temp" : "humid")
+);
+
+TRACE_EVENT(sht20_measure_end,
+	TP_PROTO(u8 cmd, int raw, int ret),
+	TP_ARGS(cmd, raw, ret),
+	TP_STRUCT__entry(
+		__field(u8, cmd)
+		__field(int, raw)
+		__field(int, ret)
+	),
+	TP_fast_assign(
+		__entry->cmd = cmd;
+		__entry->raw = raw;
+		__entry->ret = ret;
+	),
+	TP_printk("%s raw=%d ret=%d", __entry->cmd == TEMP_MEASUREMENT ? "temp" : "humid",
+		  __entry->raw, __entry->ret)
+);
+
+#endif /* _SHT20_TRACE_H */
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE sht20_trace
+#include <trace/define_trace.h>
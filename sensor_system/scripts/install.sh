@@ -4,17 +4,22 @@ echo "---- Driver Build ----"
 make clean && make
 
 echo "---- Removing Old Module ----"
+rmmod jmw_bind # sht20_driver, hd44780_driver를 사용 중이면 먼저 내려야 함
 rmmod hd44780_driver
 rmmod sht20_driver
 rmmod irq_btn_driver
+rmmod led_driver
+rmmod jmw_i2c_sched # hd44780_driver, sht20_driver가 사용 -> 마지막
 
 echo "---- Install Module ----"
+insmod ../drivers/led_driver.ko
+insmod ../drivers/jmw_i2c_sched.ko # hd44780_driver, sht20_driver보다 먼저
 insmod ../drivers/hd44780_driver.ko
 insmod ../drivers/sht20_driver.ko
 insmod ../drivers/irq_btn_driver.ko
 
 echo "---- App Build ----"
 cd ../app/
-gcc -o app app.c
+make clean && make
 
-./app
+./sensord
@@ -0,0 +1,87 @@
+#ifndef JMW_SIM_H
+#define JMW_SIM_H
+
+#include <linux/types.h>
+#include <linux/i2c.h>
+#include <linux/mutex.h>
+#include <linux/seq_file.h>
+
+/*
+ * 하드웨어 없이 드라이버를 돌리기 위한 가짜 I2C 버스
+ * 실제 드라이버(sht20_driver, hd44780_driver)는 수정 없이 이 adapter에 붙음
+ *
+ * sim_bus.c     adapter, 버스 시간 계산, debugfs
+ * sim_sht20.c   SHT20 (0x40): 변환 시간, CRC, user register
+ * sim_hd44780.c PCF8574 (0x27) + HD44780: 니블 -> 명령 / DDRAM
+ */
+
+#define SIM_SHT20_ADDR 0x40
+#define SIM_LCD_ADDR 0x27
+
+/* 버스 전체 (xfer 하나가 끝날때까지 bus lock은 i2c core가 잡고 있음) */
+struct sim_bus_stats {
+	u64 xfers;  // master_xfer 호출 (START ~ STOP)
+	u64 msgs;   // START / repeated START 단위
+	u64 bytes;
+	u64 bits;   // SCL 클럭 수: START/STOP + (주소 + 데이터) * 9 (ACK 포함)
+	u64 nacks;
+};
+
+struct sim_sht20 {
+	u8 user_reg;
+	u8 cmd;      // 마지막 측정 명령 (0이면 없음)
+	u64 ready_ns; // 변환 / reset 끝나는 시각
+	u16 raw;
+
+	u64 measurements;
+	u64 resets;
+	u64 busy_nacks;  // 변환 중 no-hold read
+	u64 stretch_ns;  // hold master 모드에서 clock stretching으로 버스를 잡은 시간
+};
+
+#define SIM_LCD_DDRAM 0x80
+
+struct sim_lcd {
+	u8 last;      // 마지막 PCF8574 출력
+	bool four_bit; // 4비트 interface (DL=0)
+	bool have_high; // 4비트 모드에서 상위 니블 받음
+	u8 high;
+	u8 ac;        // address counter
+	bool inc;     // entry mode I/D
+	bool cgram;   // CGRAM 주소 설정 후 data는 DDRAM에 안 씀
+	bool display;
+	u8 ddram[SIM_LCD_DDRAM];
+	u64 busy_until; // 앞 명령 실행 끝나는 시각
+
+	u64 nibbles;
+	u64 instructions;
+	u64 data;
+	u64 clears;
+	u64 busy_violations; // 실행 중에 다음 니블 latch (실제 LCD면 무시되거나 깨짐)
+};
+
+struct sim {
+	struct i2c_adapter adap;
+	struct mutex lock; // xfer와 debugfs 읽기
+	struct sim_bus_stats bus;
+	u64 bus_ns; // sleep 하지 않은 버스 시간 합 = 모델 시각 offset (통계 reset과 무관, 줄면 안됨)
+	struct sim_sht20 sht20;
+	struct sim_lcd lcd;
+	struct i2c_client *sht20_client;
+	struct i2c_client *lcd_client;
+	struct dentry *dir;
+};
+
+/*
+ * 모델 (sim->lock 잡은 상태에서 호출)
+ * @now: 모델 시각 (ns), 메시지 마지막 바이트가 버스에서 끝난 시점
+ */
+void sim_sht20_reset(struct sim_sht20 *s);
+int sim_sht20_xfer(struct sim_sht20 *s, struct i2c_msg *msg, u64 now);
+void sim_sht20_show(struct seq_file *m, struct sim_sht20 *s);
+
+void sim_lcd_reset(struct sim_lcd *l);
+int sim_lcd_xfer(struct sim_lcd *l, struct i2c_msg *msg, u64 now);
+void sim_lcd_show(struct seq_file *m, struct sim_lcd *l);
+
+#endif
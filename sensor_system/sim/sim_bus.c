@@ -0,0 +1,243 @@
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/slab.h>
+#include <linux/i2c.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <linux/delay.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+
+#include "sim.h"
+
+/*
+ * 가짜 I2C adapter
+ * insmod하면 adapter를 만들고 SHT20 (0x40), PCF8574 LCD (0x27) client를 붙임
+ * -> sht20_driver, hd44780_driver가 id_table로 bind (DT 없이 x86 VM에서도 동작)
+ *
+ * 버스 시간: 메시지마다 START + (주소 + 데이터 바이트) * 9 + STOP 클럭을 bus_hz로 환산
+ *  - bus_delay=0 (기본): 실제로 기다리지 않고 모델 시각만 앞으로 -> 빠른 회귀 측정
+ *  - bus_delay=1: 그만큼 실제로 sleep -> 드라이버 쪽 지연도 실제 버스와 비슷
+ *
+ * /sys/kernel/debug/jmw_i2c_sim/
+ *  bus    전송 횟수, 바이트, 클럭 수, NACK, 버스 시간
+ *  sht20  측정 횟수, clock stretching 시간, user register
+ *  lcd    DDRAM 내용 (16x2), 니블 / 명령 / data 수, busy 위반
+ *  reset  아무 값이나 쓰면 카운터 초기화 (모델 상태는 유지)
+ */
+
+#define SIM_NAME "jmw-i2c-sim"
+
+static unsigned int bus_hz = 100000;
+module_param(bus_hz, uint, 0444);
+MODULE_PARM_DESC(bus_hz, "simulated SCL frequency (Pi i2c_arm default 100 kHz)");
+
+static bool bus_delay;
+module_param(bus_delay, bool, 0644);
+MODULE_PARM_DESC(bus_delay, "sleep for the simulated bus time of each transfer");
+
+static bool sht20 = true;
+module_param(sht20, bool, 0444);
+MODULE_PARM_DESC(sht20, "instantiate the SHT20 model at 0x40");
+
+static bool lcd = true;
+module_param(lcd, bool, 0444);
+MODULE_PARM_DESC(lcd, "instantiate the PCF8574/HD44780 model at 0x27");
+
+static struct sim *sim;
+
+static int sim_xfer(struct i2c_adapter *adap, struct i2c_msg *msgs, int num) {
+	struct sim *s = i2c_get_adapdata(adap);
+	u64 bit_ns = div_u64(NSEC_PER_SEC, bus_hz);
+	u64 bits = 1; // STOP
+	int ret = num;
+	int i;
+
+	mutex_lock(&s->lock);
+	s->bus.xfers++;
+
+	for (i = 0; i < num; i++) {
+		struct i2c_msg *msg = &msgs[i];
+		u64 now;
+		int err;
+
+		s->bus.msgs++;
+		bits += 1 + 9 * (1 + msg->len); // (repeated) START + 주소 + 데이터
+
+		/*
+		 * 모델 시각 = 실제 시각 + sleep 하지 않은 버스 시간
+		 * -> bus_delay=0 이어도 LCD busy 검사, SHT20 변환 시간이 실제 버스 기준으로 맞음
+		 */
+		now = ktime_get_ns() + s->bus_ns + bits * bit_ns;
+
+		switch (msg->addr) {
+		case SIM_SHT20_ADDR:
+			err = sht20 ? sim_sht20_xfer(&s->sht20, msg, now) : -ENXIO;
+			break;
+		case SIM_LCD_ADDR:
+			err = lcd ? sim_lcd_xfer(&s->lcd, msg, now) : -ENXIO;
+			break;
+		default:
+			err = -ENXIO;
+			break;
+		}
+
+		if (err < 0) {
+			// 주소 / 데이터 NACK -> 나머지 메시지 버리고 STOP
+			s->bus.nacks++;
+			ret = err;
+			break;
+		}
+		s->bus.bytes += msg->len;
+	}
+
+	s->bus.bits += bits;
+	if (!READ_ONCE(bus_delay))
+		s->bus_ns += bits * bit_ns;
+	mutex_unlock(&s->lock);
+
+	if (READ_ONCE(bus_delay))
+		fsleep(div_u64(bits * bit_ns, NSEC_PER_USEC));
+
+	return ret;
+}
+
+static u32 sim_func(struct i2c_adapter *adap) {
+	return I2C_FUNC_I2C | I2C_FUNC_SMBUS_EMUL;
+}
+
+static const struct i2c_algorithm sim_algo = {
+	.master_xfer = sim_xfer,
+	.functionality = sim_func,
+};
+
+static int bus_show(struct seq_file *m, void *v) {
+	struct sim *s = m->private;
+
+	mutex_lock(&s->lock);
+	seq_printf(m, "bus_hz: %u\n", bus_hz);
+	seq_printf(m, "xfers: %llu\n", s->bus.xfers);
+	seq_printf(m, "msgs: %llu\n", s->bus.msgs);
+	seq_printf(m, "bytes: %llu\n", s->bus.bytes);
+	seq_printf(m, "bits: %llu\n", s->bus.bits);
+	seq_printf(m, "nacks: %llu\n", s->bus.nacks);
+	seq_printf(m, "bus_us: %llu\n", div_u64(s->bus.bits * div_u64(NSEC_PER_SEC, bus_hz), NSEC_PER_USEC));
+	mutex_unlock(&s->lock);
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(bus);
+
+static int sht20_show(struct seq_file *m, void *v) {
+	struct sim *s = m->private;
+
+	mutex_lock(&s->lock);
+	sim_sht20_show(m, &s->sht20);
+	mutex_unlock(&s->lock);
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(sht20);
+
+static int lcd_show(struct seq_file *m, void *v) {
+	struct sim *s = m->private;
+
+	mutex_lock(&s->lock);
+	sim_lcd_show(m, &s->lcd);
+	mutex_unlock(&s->lock);
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(lcd);
+
+// 카운터만 0으로, LCD 4비트 모드 / DDRAM, SHT20 user register, 모델 시각 (bus_ns)은 그대로
+static ssize_t reset_write(struct file *file, const char __user *buf, size_t len, loff_t *pos) {
+	struct sim *s = file_inode(file)->i_private;
+
+	mutex_lock(&s->lock);
+	memset(&s->bus, 0, sizeof(s->bus));
+	s->sht20.measurements = 0;
+	s->sht20.resets = 0;
+	s->sht20.busy_nacks = 0;
+	s->sht20.stretch_ns = 0;
+	s->lcd.nibbles = 0;
+	s->lcd.instructions = 0;
+	s->lcd.data = 0;
+	s->lcd.clears = 0;
+	s->lcd.busy_violations = 0;
+	mutex_unlock(&s->lock);
+	return len;
+}
+
+static const struct file_operations reset_fops = {
+	.owner = THIS_MODULE,
+	.write = reset_write,
+};
+
+static struct i2c_client *sim_add_client(struct sim *s, const char *type, unsigned short addr) {
+	struct i2c_board_info info = { .addr = addr };
+	struct i2c_client *client;
+
+	strscpy(info.type, type, sizeof(info.type));
+	client = i2c_new_client_device(&s->adap, &info);
+	if (IS_ERR(client)) {
+		printk(KERN_ERR "%s client add fail\n", type);
+		return NULL;
+	}
+	return client;
+}
+
+static int __init sim_init(void) {
+	int ret;
+
+	if (bus_hz == 0)
+		return -EINVAL;
+
+	sim = kzalloc(sizeof(*sim), GFP_KERNEL);
+	if (sim == NULL)
+		return -ENOMEM;
+
+	mutex_init(&sim->lock);
+	sim_sht20_reset(&sim->sht20);
+	sim_lcd_reset(&sim->lcd);
+
+	sim->adap.owner = THIS_MODULE;
+	sim->adap.algo = &sim_algo;
+	sim->adap.nr = -1; // 번호는 core가 할당
+	strscpy(sim->adap.name, SIM_NAME, sizeof(sim->adap.name));
+	i2c_set_adapdata(&sim->adap, sim);
+
+	ret = i2c_add_adapter(&sim->adap);
+	if (ret < 0) {
+		printk(KERN_ERR "i2c add adapter fail\n");
+		kfree(sim);
+		return ret;
+	}
+
+	sim->dir = debugfs_create_dir("jmw_i2c_sim", NULL);
+	debugfs_create_file("bus", 0444, sim->dir, sim, &bus_fops);
+	debugfs_create_file("sht20", 0444, sim->dir, sim, &sht20_fops);
+	debugfs_create_file("lcd", 0444, sim->dir, sim, &lcd_fops);
+	debugfs_create_file("reset", 0200, sim->dir, sim, &reset_fops);
+
+	// 드라이버가 먼저 로드되어 있으면 여기서 바로 probe
+	if (sht20)
+		sim->sht20_client = sim_add_client(sim, "sht20", SIM_SHT20_ADDR);
+	if (lcd)
+		sim->lcd_client = sim_add_client(sim, "hd44780", SIM_LCD_ADDR);
+
+	printk(KERN_INFO "%s: i2c-%d\n", SIM_NAME, sim->adap.nr);
+	return 0;
+}
+
+static void __exit sim_exit(void) {
+	i2c_unregister_device(sim->lcd_client); // NULL이면 아무것도 안함
+	i2c_unregister_device(sim->sht20_client);
+	i2c_del_adapter(&sim->adap);
+	debugfs_remove_recursive(sim->dir);
+	kfree(sim);
+}
+
+module_init(sim_init);
+module_exit(sim_exit);
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("Simulated I2C bus with SHT20 and PCF8574/HD44780 models");
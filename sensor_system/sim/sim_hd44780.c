@@ -0,0 +1,151 @@
+#include <linux/kernel.h>
+#include <linux/string.h>
+
+#include "sim.h"
+
+/*
+ * PCF8574 + HD44780 모델
+ *
+ * PCF8574 출력 핀: P0 RS, P1 RW, P2 E, P3 BL, P4~P7 D4~D7 (hd44780_driver와 같은 배선)
+ * E 하강 엣지에서 D4~D7 latch
+ *  - 8비트 interface (전원 인가 직후): 니블 하나가 명령 하나 (D0~D3 = 0)
+ *  - 4비트 interface: 상위 -> 하위 니블 두개가 한 바이트
+ *
+ * 실행 시간 (데이터시트, fosc 270kHz): 일반 명령 37us, data 쓰기 41us, clear/home 1.52ms
+ * 실행 중에 다음 니블이 latch되면 busy_violations (실제 LCD면 무시되거나 화면 깨짐)
+ */
+
+#define PCF_RS (1 << 0)
+#define PCF_E (1 << 2)
+
+#define EXEC_NS 37000
+#define EXEC_DATA_NS 41000
+#define EXEC_CLEAR_NS 1520000
+
+#define LINE2 0x40
+#define LINE_LEN 0x28 // 한 줄 DDRAM 40칸
+
+void sim_lcd_reset(struct sim_lcd *l) {
+	// 전원 인가 후 내부 reset 상태: DL=1, I/D=1, display off, 화면 clear
+	memset(l, 0, sizeof(*l));
+	memset(l->ddram, ' ', sizeof(l->ddram));
+	l->inc = true;
+}
+
+// 2줄 모드 address counter: 0x00~0x27, 0x40~0x67
+static void lcd_advance(struct sim_lcd *l, bool inc) {
+	if (inc) {
+		l->ac++;
+		if (l->ac == LINE_LEN)
+			l->ac = LINE2;
+		else if (l->ac == LINE2 + LINE_LEN)
+			l->ac = 0;
+	} else {
+		if (l->ac == 0)
+			l->ac = LINE2 + LINE_LEN - 1;
+		else if (l->ac == LINE2)
+			l->ac = LINE_LEN - 1;
+		else
+			l->ac--;
+	}
+	l->ac &= SIM_LCD_DDRAM - 1;
+}
+
+static void lcd_instruction(struct sim_lcd *l, u8 b, u64 now) {
+	u64 exec = EXEC_NS;
+
+	l->instructions++;
+
+	if (b & 0x80) { // set DDRAM address
+		l->ac = b & 0x7F;
+		l->cgram = false;
+	} else if (b & 0x40) { // set CGRAM address
+		l->cgram = true;
+	} else if (b & 0x20) { // function set
+		l->four_bit = !(b & 0x10);
+		l->have_high = false;
+	} else if (b & 0x10) { // cursor / display shift
+		if (!(b & 0x08))
+			lcd_advance(l, b & 0x04);
+	} else if (b & 0x08) { // display on/off
+		l->display = b & 0x04;
+	} else if (b & 0x04) { // entry mode
+		l->inc = b & 0x02;
+	} else if (b & 0x02) { // return home
+		l->ac = 0;
+		exec = EXEC_CLEAR_NS;
+	} else if (b & 0x01) { // clear display
+		memset(l->ddram, ' ', sizeof(l->ddram));
+		l->ac = 0;
+		l->inc = true;
+		l->clears++;
+		exec = EXEC_CLEAR_NS;
+	}
+
+	l->busy_until = now + exec;
+}
+
+static void lcd_data(struct sim_lcd *l, u8 b, u64 now) {
+	l->data++;
+	if (!l->cgram) {
+		l->ddram[l->ac] = b;
+		lcd_advance(l, l->inc);
+	}
+	l->busy_until = now + EXEC_DATA_NS;
+}
+
+static void lcd_latch(struct sim_lcd *l, u8 pins, u64 now) {
+	u8 nibble = pins & 0xF0;
+	bool rs = pins & PCF_RS;
+	u8 b;
+
+	l->nibbles++;
+	if (now < l->busy_until)
+		l->busy_violations++;
+
+	if (!l->four_bit) {
+		b = nibble;
+	} else if (!l->have_high) {
+		l->high = nibble;
+		l->have_high = true;
+		return;
+	} else {
+		b = l->high | (nibble >> 4);
+		l->have_high = false;
+	}
+
+	if (rs)
+		lcd_data(l, b, now);
+	else
+		lcd_instruction(l, b, now);
+}
+
+int sim_lcd_xfer(struct sim_lcd *l, struct i2c_msg *msg, u64 now) {
+	if (msg->flags & I2C_M_RD) {
+		// PCF8574 read: 핀 상태 (드라이버는 안 씀)
+		memset(msg->buf, l->last, msg->len);
+		return 0;
+	}
+
+	for (int i = 0; i < msg->len; i++) {
+		u8 pins = msg->buf[i];
+
+		if ((l->last & PCF_E) && !(pins & PCF_E))
+			lcd_latch(l, l->last, now);
+		l->last = pins;
+	}
+	return 0;
+}
+
+void sim_lcd_show(struct seq_file *m, struct sim_lcd *l) {
+	seq_printf(m, "display: %s, %s-bit\n", l->display ? "on" : "off", l->four_bit ? "4" : "8");
+	seq_printf(m, "+----------------+\n");
+	seq_printf(m, "|%.16s|\n", l->ddram);
+	seq_printf(m, "|%.16s|\n", l->ddram + LINE2);
+	seq_printf(m, "+----------------+\n");
+	seq_printf(m, "nibbles: %llu\n", l->nibbles);
+	seq_printf(m, "instructions: %llu\n", l->instructions);
+	seq_printf(m, "data: %llu\n", l->data);
+	seq_printf(m, "clears: %llu\n", l->clears);
+	seq_printf(m, "busy_violations: %llu\n", l->busy_violations);
+}
@@ -0,0 +1,200 @@
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/delay.h>
+#include <linux/math64.h>
+
+#include "sim.h"
+#include "sht20_conv.h" // sht20_crc8 (드라이버와 같은 구현)
+
+/*
+ * SHT20 모델
+ * 데이터시트의 명령, user register, 해상도별 최대 변환 시간, CRC-8 (x^8 + x^5 + x^4 + 1)
+ *
+ * hold master (0xE3/0xE5): 변환이 안 끝났으면 read에서 clock stretching -> 그동안 버스 점유
+ * no hold (0xF3/0xF5): 변환 중 read는 NACK
+ * 변환 / soft reset 중의 write도 NACK
+ */
+
+#define CMD_T_HOLD 0xE3
+#define CMD_RH_HOLD 0xE5
+#define CMD_T_NOHOLD 0xF3
+#define CMD_RH_NOHOLD 0xF5
+#define CMD_WRITE_UR 0xE6
+#define CMD_READ_UR 0xE7
+#define CMD_SOFT_RESET 0xFE
+
+#define UR_DEFAULT 0x02
+#define UR_WRITABLE 0x87 // bit 7,0 해상도, bit 2 heater, bit 1 OTP reload (3~5 reserved)
+#define SOFT_RESET_MS 15
+
+static int temp_mc = 25000;
+module_param(temp_mc, int, 0644);
+MODULE_PARM_DESC(temp_mc, "simulated temperature in milli-degC");
+
+static int humid_mpct = 45000;
+module_param(humid_mpct, int, 0644);
+MODULE_PARM_DESC(humid_mpct, "simulated relative humidity in milli-percent");
+
+static unsigned int conv_pct = 100;
+module_param(conv_pct, uint, 0644);
+MODULE_PARM_DESC(conv_pct, "conversion/reset time in percent of the datasheet maximum (0 = instant)");
+
+static unsigned int crc_corrupt_every;
+module_param(crc_corrupt_every, uint, 0644);
+MODULE_PARM_DESC(crc_corrupt_every, "corrupt the CRC of every Nth measurement (0 = never)");
+
+/*
+ * 해상도 (user register bit 7, 0) 별 최대 변환 시간(ms)과 유효 비트
+ * index = bit7 << 1 | bit0
+ */
+static const struct {
+	u8 t_ms;
+	u8 rh_ms;
+	u16 t_mask;
+	u16 rh_mask;
+} sht20_res[4] = {
+	{ 85, 29, 0xFFFC, 0xFFF0 }, // T 14bit, RH 12bit
+	{ 22, 4, 0xFFF0, 0xFF00 },  // T 12bit, RH 8bit
+	{ 43, 9, 0xFFF8, 0xFFC0 },  // T 13bit, RH 10bit
+	{ 11, 15, 0xFFE0, 0xFFE0 }, // T 11bit, RH 11bit
+};
+
+static int sht20_res_idx(u8 user_reg) {
+	return ((user_reg >> 6) & 2) | (user_reg & 1);
+}
+
+static bool sht20_is_temp(u8 cmd) {
+	return cmd == CMD_T_HOLD || cmd == CMD_T_NOHOLD;
+}
+
+static bool sht20_is_measure(u8 cmd) {
+	return sht20_is_temp(cmd) || cmd == CMD_RH_HOLD || cmd == CMD_RH_NOHOLD;
+}
+
+static u64 sht20_delay_ns(unsigned int ms) {
+	return (u64)ms * READ_ONCE(conv_pct) * NSEC_PER_MSEC / 100;
+}
+
+/*
+ * 물리량 -> raw (sht20_conv.h 변환식의 역)
+ * T = -46.85 + 175.72 * raw / 2^16
+ * RH = -6 + 125 * raw / 2^16
+ */
+static u16 sht20_raw(u8 cmd, u8 user_reg) {
+	int idx = sht20_res_idx(user_reg);
+	s64 raw;
+	u16 mask;
+
+	if (sht20_is_temp(cmd)) {
+		raw = div_s64(((s64)READ_ONCE(temp_mc) + 46850) << 16, 175720);
+		mask = sht20_res[idx].t_mask;
+	} else {
+		raw = div_s64(((s64)READ_ONCE(humid_mpct) + 6000) << 16, 125000);
+		mask = sht20_res[idx].rh_mask;
+	}
+	raw = clamp_t(s64, raw, 0, 0xFFFF);
+
+	// 하위 2비트는 status: bit 1 = 0 온도, 1 습도
+	return (raw & mask) | (sht20_is_temp(cmd) ? 0 : 0x2);
+}
+
+void sim_sht20_reset(struct sim_sht20 *s) {
+	memset(s, 0, sizeof(*s));
+	s->user_reg = UR_DEFAULT;
+}
+
+static int sht20_write(struct sim_sht20 *s, struct i2c_msg *msg, u64 now) {
+	u8 cmd = msg->buf[0];
+
+	if (now < s->ready_ns) {
+		s->busy_nacks++;
+		return -ENXIO;
+	}
+
+	if (sht20_is_measure(cmd)) {
+		int idx = sht20_res_idx(s->user_reg);
+		unsigned int ms = sht20_is_temp(cmd) ? sht20_res[idx].t_ms : sht20_res[idx].rh_ms;
+
+		s->cmd = cmd;
+		s->raw = sht20_raw(cmd, s->user_reg);
+		s->ready_ns = now + sht20_delay_ns(ms);
+		return 0;
+	}
+
+	switch (cmd) {
+	case CMD_WRITE_UR:
+		if (msg->len < 2)
+			return -EIO;
+		s->user_reg = (s->user_reg & ~UR_WRITABLE) | (msg->buf[1] & UR_WRITABLE);
+		s->cmd = 0;
+		return 0;
+	case CMD_READ_UR:
+		s->cmd = cmd;
+		return 0;
+	case CMD_SOFT_RESET:
+		s->user_reg = UR_DEFAULT; // heater 끄고 해상도 기본값 (OTP reload)
+		s->cmd = 0;
+		s->ready_ns = now + sht20_delay_ns(SOFT_RESET_MS);
+		s->resets++;
+		return 0;
+	default:
+		return -ENXIO; // 모르는 명령은 NACK
+	}
+}
+
+static int sht20_read(struct sim_sht20 *s, struct i2c_msg *msg, u64 now) {
+	u8 out[3];
+
+	if (s->cmd == CMD_READ_UR) {
+		msg->buf[0] = s->user_reg;
+		return 0;
+	}
+
+	if (!sht20_is_measure(s->cmd)) {
+		s->busy_nacks += now < s->ready_ns; // soft reset 중
+		return -ENXIO;
+	}
+
+	if (now < s->ready_ns) {
+		u64 wait_ns = s->ready_ns - now;
+
+		if (s->cmd == CMD_T_NOHOLD || s->cmd == CMD_RH_NOHOLD) {
+			s->busy_nacks++;
+			return -ENXIO;
+		}
+		// hold master: 변환 끝날때까지 SCL을 잡고 있음
+		usleep_range(div_u64(wait_ns, NSEC_PER_USEC), div_u64(wait_ns, NSEC_PER_USEC) + 100);
+		s->stretch_ns += wait_ns;
+	}
+
+	out[0] = s->raw >> 8;
+	out[1] = s->raw & 0xFF;
+	out[2] = sht20_crc8(out, 2);
+	s->measurements++;
+	if (crc_corrupt_every && s->measurements % crc_corrupt_every == 0)
+		out[2] ^= 0xFF;
+
+	memcpy(msg->buf, out, min_t(int, msg->len, sizeof(out)));
+	s->cmd = 0; // 결과는 한번만 읽힘
+	return 0;
+}
+
+int sim_sht20_xfer(struct sim_sht20 *s, struct i2c_msg *msg, u64 now) {
+	if (msg->len == 0)
+		return 0; // quick command (i2cdetect): ACK만
+
+	if (msg->flags & I2C_M_RD)
+		return sht20_read(s, msg, now);
+	return sht20_write(s, msg, now);
+}
+
+void sim_sht20_show(struct seq_file *m, struct sim_sht20 *s) {
+	int idx = sht20_res_idx(s->user_reg);
+
+	seq_printf(m, "user_reg: 0x%02x (T max %u ms, RH max %u ms)\n",
+		   s->user_reg, sht20_res[idx].t_ms, sht20_res[idx].rh_ms);
+	seq_printf(m, "measurements: %llu\n", s->measurements);
+	seq_printf(m, "resets: %llu\n", s->resets);
+	seq_printf(m, "busy_nacks: %llu\n", s->busy_nacks);
+	seq_printf(m, "stretch_us: %llu\n", div_u64(s->stretch_ns, NSEC_PER_USEC));
+}
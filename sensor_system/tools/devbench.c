@@ -0,0 +1,521 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "hist.h"
+
+/*
+ * devbench: 드라이버 device node 벤치마크
+ *
+ * 워크로드마다 스레드 N개가 같은 device를 열고 주기(-r) 또는 최대 속도로 반복
+ * 지연은 HDR 히스토그램 (hist.h), 결과는 JSON
+ * -r로 속도를 정하면 지연은 "원래 보냈어야 할 시각"부터 잼
+ *  -> 드라이버가 밀려서 다음 요청이 늦게 나가도 그 대기 시간이 지연에 포함 (coordinated omission 보정)
+ *
+ * -b baseline.json: 이전 결과와 비교, -t 보다 나빠지면 exit 1 (CI용)
+ */
+
+#define MAX_WORKLOADS 8
+#define MAX_THREADS 64
+#define DEFAULT_DURATION_S 10
+#define DEFAULT_WRITE_SIZE 16 // LCD 한 줄
+#define DEFAULT_THRESHOLD_PCT 10.0
+
+struct workload;
+
+struct workload_type {
+	const char *name;
+	const char *dev;
+	int flags;
+	// 한번 수행, 0 성공 / -1 에러, *bytes에 주고받은 바이트
+	int (*op)(struct workload *w, int fd, uint64_t seq, size_t *bytes);
+};
+
+struct worker {
+	pthread_t th;
+	struct workload *w;
+	struct hist hist;
+	uint64_t ops;
+	uint64_t errors;
+	uint64_t bytes;
+	uint64_t events; // button: 실제로 눌림을 읽은 횟수
+};
+
+struct workload {
+	const struct workload_type *type;
+	int threads;
+	struct worker workers[MAX_THREADS];
+
+	// 합친 결과
+	struct hist hist;
+	uint64_t ops;
+	uint64_t errors;
+	uint64_t bytes;
+	uint64_t events;
+};
+
+static atomic_int stop;
+static double rate; // 스레드당 ops/s, 0이면 최대 속도
+static size_t write_size = DEFAULT_WRITE_SIZE;
+
+static uint64_t now_ns(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void sleep_until(uint64_t ns) {
+	struct timespec ts = {
+		.tv_sec = ns / 1000000000ULL,
+		.tv_nsec = ns % 1000000000ULL,
+	};
+
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+		;
+}
+
+/* 드라이버는 *pos를 올리지 않음 -> 같은 fd로 계속 read 가능 */
+static int op_sht20_read(struct workload *w, int fd, uint64_t seq, size_t *bytes) {
+	char buf[32];
+	ssize_t len = read(fd, buf, sizeof(buf));
+
+	if (len <= 0)
+		return -1;
+	*bytes = len;
+	return 0;
+}
+
+static int op_lcd_write(struct workload *w, int fd, uint64_t seq, size_t *bytes) {
+	char buf[64];
+	ssize_t len;
+
+	// 매번 다른 내용 (드라이버는 31바이트에서 자름)
+	for (size_t i = 0; i < write_size; i++)
+		buf[i] = 'A' + (seq + i) % 26;
+
+	len = write(fd, buf, write_size);
+	if (len < 0)
+		return -1;
+	*bytes = len;
+	return 0;
+}
+
+/*
+ * O_NONBLOCK read: 안 눌렸으면 EAGAIN (syscall 비용만 측정), 눌렸으면 event
+ */
+static int op_button_read(struct workload *w, int fd, uint64_t seq, size_t *bytes) {
+	char c;
+	ssize_t len = read(fd, &c, 1);
+
+	if (len == 1) {
+		*bytes = 1;
+		return 1;
+	}
+	if (len < 0 && errno == EAGAIN)
+		return 0;
+	return -1;
+}
+
+static int op_led_write(struct workload *w, int fd, uint64_t seq, size_t *bytes) {
+	char c = (seq & 1) ? '1' : '0';
+
+	if (write(fd, &c, 1) != 1)
+		return -1;
+	*bytes = 1;
+	return 0;
+}
+
+static const struct workload_type types[] = {
+	{ "sht20-read", "/dev/sht20_device", O_RDONLY, op_sht20_read },
+	{ "lcd-write", "/dev/hd44780_device", O_WRONLY, op_lcd_write },
+	{ "button-read", "/dev/button_device", O_RDONLY | O_NONBLOCK, op_button_read },
+	{ "led-write", "/dev/LED_DEVICE", O_WRONLY, op_led_write },
+};
+
+static void *worker_thread(void *arg) {
+	struct worker *wk = arg;
+	struct workload *w = wk->w;
+	uint64_t interval = rate > 0 ? (uint64_t)(1e9 / rate) : 0;
+	uint64_t next = now_ns();
+	uint64_t seq = 0;
+	int fd;
+
+	fd = open(w->type->dev, w->type->flags | O_CLOEXEC);
+	if (fd < 0) {
+		perror(w->type->dev);
+		wk->errors++;
+		return NULL;
+	}
+
+	while (!atomic_load_explicit(&stop, memory_order_relaxed)) {
+		size_t bytes = 0;
+		uint64_t start;
+		int ret;
+
+		if (interval) {
+			sleep_until(next);
+			start = next; // 밀렸어도 예정 시각 기준
+			next += interval;
+		} else {
+			start = now_ns();
+		}
+
+		ret = w->type->op(w, fd, seq++, &bytes);
+		hist_record(&wk->hist, now_ns() - start);
+		wk->ops++;
+		if (ret < 0) {
+			wk->errors++;
+		} else {
+			wk->bytes += bytes;
+			wk->events += ret > 0;
+		}
+	}
+
+	close(fd);
+	return NULL;
+}
+
+/*
+ * "이름" 또는 "이름:스레드수"
+ */
+static int parse_workload(struct workload *w, const char *spec) {
+	const char *colon = strchr(spec, ':');
+	size_t len = colon ? (size_t)(colon - spec) : strlen(spec);
+
+	memset(w, 0, sizeof(*w));
+	for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+		if (strlen(types[i].name) == len && strncmp(types[i].name, spec, len) == 0)
+			w->type = &types[i];
+	}
+	if (w->type == NULL) {
+		fprintf(stderr, "unknown workload: %s\n", spec);
+		return -1;
+	}
+
+	w->threads = colon ? atoi(colon + 1) : 1;
+	if (w->threads < 1 || w->threads > MAX_THREADS) {
+		fprintf(stderr, "threads must be 1..%d: %s\n", MAX_THREADS, spec);
+		return -1;
+	}
+	return 0;
+}
+
+static void collect(struct workload *w) {
+	hist_init(&w->hist);
+	for (int i = 0; i < w->threads; i++) {
+		struct worker *wk = &w->workers[i];
+
+		hist_merge(&w->hist, &wk->hist);
+		w->ops += wk->ops;
+		w->errors += wk->errors;
+		w->bytes += wk->bytes;
+		w->events += wk->events;
+	}
+}
+
+/* ---- baseline 비교 ---- */
+
+/*
+ * 직접 만든 JSON만 읽음 (키 순서 고정): "name": "<workload>" 다음 워크로드 전까지
+ * section이 NULL이면 "latency_us" 앞 (ops_per_s 등), 아니면 그 객체 { } 안에서만 검색
+ * -> 이전 -b 결과의 "compare" 안에 있는 같은 이름의 키는 안 봄
+ * @return: 0, 키 없음 -1, 값이 숫자가 아님 -2
+ */
+static int baseline_get(const char *json, const char *name, const char *section, const char *key,
+			double *val) {
+	char pat[64];
+	const char *obj;
+	const char *end;
+	const char *lat;
+	const char *p;
+	char *num_end;
+
+	snprintf(pat, sizeof(pat), "\"name\": \"%s\"", name);
+	obj = strstr(json, pat);
+	if (obj == NULL)
+		return -1;
+	end = strstr(obj + 1, "\"name\":");
+
+	lat = strstr(obj, "\"latency_us\": {");
+	if (lat != NULL && end != NULL && lat > end)
+		lat = NULL;
+
+	if (section != NULL) {
+		if (lat == NULL)
+			return -1;
+		obj = lat;
+		end = strchr(lat, '}');
+	} else if (lat != NULL) {
+		end = lat;
+	}
+
+	snprintf(pat, sizeof(pat), "\"%s\":", key);
+	p = strstr(obj, pat);
+	if (p == NULL || (end != NULL && p > end))
+		return -1;
+
+	p += strlen(pat);
+	*val = strtod(p, &num_end);
+	if (num_end == p)
+		return -2;
+	return 0;
+}
+
+static char *read_file(const char *path) {
+	FILE *fp = fopen(path, "r");
+	char *buf;
+	long size;
+
+	if (fp == NULL)
+		return NULL;
+
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	rewind(fp);
+
+	buf = malloc(size + 1);
+	if (buf != NULL && fread(buf, 1, size, fp) == (size_t)size) {
+		buf[size] = '\0';
+	} else {
+		free(buf);
+		buf = NULL;
+	}
+	fclose(fp);
+	return buf;
+}
+
+static double pct_change(double base, double cur) {
+	return base > 0 ? (cur - base) * 100.0 / base : 0;
+}
+
+/*
+ * 처리량은 줄면, 지연은 늘면 나빠진 것
+ * max는 한번의 스케줄링 지연에도 크게 흔들림 -> 보여주기만 하고 판정에서 제외
+ * @return: threshold 넘게 나빠진 항목 수
+ */
+static int compare(FILE *out, const char *baseline, const struct workload *w, double duration_s,
+		   double threshold) {
+	static const struct {
+		const char *section;
+		const char *key;
+		int higher_is_better;
+		int gate;
+	} keys[] = {
+		{ NULL, "ops_per_s", 1, 1 },
+		{ "latency_us", "p50", 0, 1 },
+		{ "latency_us", "p99", 0, 1 },
+		{ "latency_us", "p999", 0, 1 },
+		{ "latency_us", "max", 0, 0 },
+	};
+	double cur[] = {
+		w->ops / duration_s,
+		hist_percentile(&w->hist, 50) / 1000.0,
+		hist_percentile(&w->hist, 99) / 1000.0,
+		hist_percentile(&w->hist, 99.9) / 1000.0,
+		w->hist.max / 1000.0,
+	};
+	int regressions = 0;
+	int first = 1;
+
+	fprintf(out, ",\n      \"compare\": {");
+	for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+		double base;
+		double change;
+		int worse;
+
+		switch (baseline_get(baseline, w->type->name, keys[i].section, keys[i].key, &base)) {
+		case -1:
+			continue;
+		case -2: // 통과로 넘어가면 안됨 -> 회귀로 셈
+			fprintf(stderr, "%-12s %-10s bad baseline value\n", w->type->name, keys[i].key);
+			regressions += keys[i].gate;
+			continue;
+		}
+
+		change = pct_change(base, cur[i]);
+		worse = keys[i].gate &&
+			(keys[i].higher_is_better ? change < -threshold : change > threshold);
+		regressions += worse;
+
+		fprintf(out, "%s\n        \"%s\": { \"baseline\": %.3f, \"change_pct\": %.1f, \"regression\": %s }",
+			first ? "" : ",", keys[i].key, base, change, worse ? "true" : "false");
+		first = 0;
+
+		fprintf(stderr, "%-12s %-10s %12.3f -> %12.3f  %+7.1f%%%s\n", w->type->name, keys[i].key,
+			base, cur[i], change, worse ? "  REGRESSION" : "");
+	}
+	fprintf(out, "\n      }");
+	return regressions;
+}
+
+static void print_workload(FILE *out, const struct workload *w, double duration_s) {
+	const struct hist *h = &w->hist;
+
+	fprintf(out, "    {\n");
+	fprintf(out, "      \"name\": \"%s\",\n", w->type->name);
+	fprintf(out, "      \"device\": \"%s\",\n", w->type->dev);
+	fprintf(out, "      \"threads\": %d,\n", w->threads);
+	fprintf(out, "      \"ops\": %llu,\n", (unsigned long long)w->ops);
+	fprintf(out, "      \"errors\": %llu,\n", (unsigned long long)w->errors);
+	fprintf(out, "      \"bytes\": %llu,\n", (unsigned long long)w->bytes);
+	if (w->type->op == op_button_read)
+		fprintf(out, "      \"events\": %llu,\n", (unsigned long long)w->events);
+	fprintf(out, "      \"ops_per_s\": %.3f,\n", w->ops / duration_s);
+	fprintf(out, "      \"latency_us\": {\n");
+	fprintf(out, "        \"min\": %.3f,\n", h->count ? h->min / 1000.0 : 0);
+	fprintf(out, "        \"mean\": %.3f,\n", hist_mean(h) / 1000.0);
+	fprintf(out, "        \"p50\": %.3f,\n", hist_percentile(h, 50) / 1000.0);
+	fprintf(out, "        \"p99\": %.3f,\n", hist_percentile(h, 99) / 1000.0);
+	fprintf(out, "        \"p999\": %.3f,\n", hist_percentile(h, 99.9) / 1000.0);
+	fprintf(out, "        \"max\": %.3f\n", h->max / 1000.0);
+	fprintf(out, "      }");
+}
+
+static void on_signal(int sig) {
+	(void)sig;
+	atomic_store(&stop, 1);
+}
+
+static void usage(const char *prog) {
+	fprintf(stderr,
+		"usage: %s -w workload[:threads] [-w ...] [-d sec] [-r ops_per_s] [-s size]\n"
+		"          [-o out.json] [-b baseline.json] [-t pct]\n"
+		"  -w  sht20-read | lcd-write | button-read | led-write (repeatable, run concurrently)\n"
+		"  -d  duration in seconds (default %d)\n"
+		"  -r  target rate per thread, 0 = as fast as possible (default 0)\n"
+		"  -s  lcd-write size in bytes (default %d)\n"
+		"  -o  JSON output file (default stdout)\n"
+		"  -b  compare with a previous JSON result\n"
+		"  -t  regression threshold in percent (default %.0f), exit 1 if exceeded\n",
+		prog, DEFAULT_DURATION_S, DEFAULT_WRITE_SIZE, DEFAULT_THRESHOLD_PCT);
+}
+
+int main(int argc, char *argv[]) {
+	static struct workload workloads[MAX_WORKLOADS];
+	int nr_workloads = 0;
+	int duration_s = DEFAULT_DURATION_S;
+	double threshold = DEFAULT_THRESHOLD_PCT;
+	const char *out_path = NULL;
+	const char *baseline_path = NULL;
+	char *baseline = NULL;
+	double elapsed_s;
+	uint64_t t0;
+	int regressions = 0;
+	FILE *out = stdout;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "w:d:r:s:o:b:t:h")) != -1) {
+		switch (opt) {
+		case 'w':
+			if (nr_workloads == MAX_WORKLOADS) {
+				fprintf(stderr, "too many workloads\n");
+				return -1;
+			}
+			if (parse_workload(&workloads[nr_workloads++], optarg) < 0)
+				return -1;
+			break;
+		case 'd':
+			duration_s = atoi(optarg);
+			break;
+		case 'r':
+			rate = atof(optarg);
+			break;
+		case 's':
+			write_size = atoi(optarg);
+			break;
+		case 'o':
+			out_path = optarg;
+			break;
+		case 'b':
+			baseline_path = optarg;
+			break;
+		case 't':
+			threshold = atof(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? 0 : -1;
+		}
+	}
+
+	if (nr_workloads == 0 || duration_s <= 0 || rate < 0 ||
+	    write_size < 1 || write_size > 64) {
+		usage(argv[0]);
+		return -1;
+	}
+
+	if (baseline_path != NULL) {
+		baseline = read_file(baseline_path);
+		if (baseline == NULL) {
+			perror("baseline read error\n");
+			return -1;
+		}
+	}
+
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+
+	t0 = now_ns();
+	for (int i = 0; i < nr_workloads; i++) {
+		struct workload *w = &workloads[i];
+
+		for (int j = 0; j < w->threads; j++) {
+			struct worker *wk = &w->workers[j];
+
+			wk->w = w;
+			hist_init(&wk->hist);
+			if (pthread_create(&wk->th, NULL, worker_thread, wk) != 0) {
+				fprintf(stderr, "pthread create error\n");
+				return -1;
+			}
+		}
+	}
+
+	// 시그널로 일찍 끝날 수 있음
+	for (int i = 0; i < duration_s * 10 && !atomic_load(&stop); i++)
+		usleep(100000);
+	atomic_store(&stop, 1);
+
+	for (int i = 0; i < nr_workloads; i++) {
+		for (int j = 0; j < workloads[i].threads; j++)
+			pthread_join(workloads[i].workers[j].th, NULL);
+		collect(&workloads[i]);
+	}
+	elapsed_s = (now_ns() - t0) / 1e9;
+
+	if (out_path != NULL) {
+		out = fopen(out_path, "w");
+		if (out == NULL) {
+			perror("output open error\n");
+			return -1;
+		}
+	}
+
+	fprintf(out, "{\n");
+	fprintf(out, "  \"duration_s\": %.3f,\n", elapsed_s);
+	fprintf(out, "  \"rate_per_thread\": %.3f,\n", rate);
+	fprintf(out, "  \"write_size\": %zu,\n", write_size);
+	fprintf(out, "  \"workloads\": [\n");
+	for (int i = 0; i < nr_workloads; i++) {
+		print_workload(out, &workloads[i], elapsed_s);
+		if (baseline != NULL)
+			regressions += compare(out, baseline, &workloads[i], elapsed_s, threshold);
+		fprintf(out, "\n    }%s\n", i + 1 < nr_workloads ? "," : "");
+	}
+	fprintf(out, "  ]\n}\n");
+
+	if (out != stdout)
+		fclose(out);
+	free(baseline);
+
+	return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,436 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+/*
+ * devstress: 드라이버 동시성 스트레스 테스트
+ *
+ * 모든 device node를 동시에, 클라이언트 수를 1, 2, 4 ... -c 까지 늘려가며 두드림
+ * 스레드는 CPU마다 돌아가며 고정 (모든 코어에서 동시에 syscall)
+ * 단계마다 node별 처리량과 1 클라이언트 대비 비율 출력
+ *
+ * 불변식 (하나라도 깨지면 exit 1)
+ *  sht20   "%d|%d" 형식 그대로, 0 ~ 65535, status 비트 (하위 2비트) 0
+ *          -> 두 reader의 명령 / 수신이 섞이면 형식이나 값이 깨짐
+ *  lcd     write는 항상 len 반환
+ *          jmw_i2c_sim이 있으면 단계 끝의 1번째 줄이 한 writer의 내용 그대로 (스레드마다 다른 글자)
+ *          -> 니블이 섞이면 글자가 섞이거나 4비트 짝이 어긋남
+ *  button  O_NONBLOCK read는 '0' / '1' 또는 EAGAIN
+ *          누름 하나는 reader 하나만 가져감 -> 전체에서 '0'과 '1' 개수 차이 <= 1
+ *  led     '0' / '1'은 1 반환, 그 외 글자는 EINVAL
+ *
+ * 처리량이 1 클라이언트 대비 -m 비율 밑으로 떨어지면 collapse (exit 1)
+ */
+
+#define MAX_CLIENTS 64
+#define DEFAULT_STEP_S 3
+#define DEFAULT_MIN_RATIO 0.5
+#define LCD_COLS 16
+#define SIM_LCD "/sys/kernel/debug/jmw_i2c_sim/lcd"
+
+struct node;
+
+struct client {
+	pthread_t th;
+	struct node *n;
+	int id;
+	uint64_t ops;
+	uint64_t errors; // 불변식 위반
+	uint64_t zeros; // button
+	uint64_t ones;
+	int reported;
+};
+
+struct node {
+	const char *name;
+	const char *dev;
+	int flags;
+	// 한번 수행, 0 정상 / -1 불변식 위반
+	int (*op)(struct client *c, int fd, uint64_t seq);
+
+	int enabled;
+	double base_ops_per_s; // 1 클라이언트
+	uint64_t violations;
+	uint64_t zeros;
+	uint64_t ones;
+};
+
+static atomic_int stop; // 단계 끝
+static atomic_int interrupted; // SIGINT / SIGTERM
+static int nr_cpus;
+
+static uint64_t now_ns(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#define MAX_REPORTS 8 // 클라이언트당, 나머지는 개수만
+
+static void report(struct client *c, const char *what) {
+	if (c->reported++ >= MAX_REPORTS)
+		return;
+	fprintf(stderr, "%s[%d]: %s\n", c->n->name, c->id, what);
+}
+
+static int op_sht20_read(struct client *c, int fd, uint64_t seq) {
+	char buf[32];
+	ssize_t len = read(fd, buf, sizeof(buf) - 1);
+	int temp;
+	int humid;
+	int used = 0;
+
+	if (len <= 0) {
+		report(c, strerror(len < 0 ? errno : EIO));
+		return -1;
+	}
+	buf[len] = '\0';
+
+	if (sscanf(buf, "%d|%d%n", &temp, &humid, &used) != 2 || used != len) {
+		report(c, "bad format");
+		return -1;
+	}
+	if (temp < 0 || temp > 0xFFFF || humid < 0 || humid > 0xFFFF || (temp & 3) || (humid & 3)) {
+		report(c, "value out of range");
+		return -1;
+	}
+	return 0;
+}
+
+static int op_lcd_write(struct client *c, int fd, uint64_t seq) {
+	char buf[LCD_COLS];
+	ssize_t len;
+
+	// 스레드마다 다른 글자 -> 섞였는지 화면으로 확인
+	memset(buf, 'A' + c->id % 26, sizeof(buf));
+
+	len = write(fd, buf, sizeof(buf));
+	if (len != sizeof(buf)) {
+		report(c, len < 0 ? strerror(errno) : "short write");
+		return -1;
+	}
+	return 0;
+}
+
+static int op_button_read(struct client *c, int fd, uint64_t seq) {
+	char v;
+	ssize_t len = read(fd, &v, 1);
+
+	if (len < 0 && errno == EAGAIN)
+		return 0;
+	if (len != 1 || (v != '0' && v != '1')) {
+		report(c, len < 0 ? strerror(errno) : "bad value");
+		return -1;
+	}
+	if (v == '0')
+		c->zeros++;
+	else
+		c->ones++;
+	return 0;
+}
+
+static int op_led_write(struct client *c, int fd, uint64_t seq) {
+	char v = (seq & 1) ? '1' : '0';
+	ssize_t len;
+
+	// 가끔 잘못된 값 -> 에러 경로도 동시에
+	if (seq % 64 == 63) {
+		if (write(fd, "x", 1) != -1 || errno != EINVAL) {
+			report(c, "invalid value accepted");
+			return -1;
+		}
+		return 0;
+	}
+
+	len = write(fd, &v, 1);
+	if (len != 1) {
+		report(c, len < 0 ? strerror(errno) : "short write");
+		return -1;
+	}
+	return 0;
+}
+
+static struct node nodes[] = {
+	{ "sht20", "/dev/sht20_device", O_RDONLY, op_sht20_read },
+	{ "lcd", "/dev/hd44780_device", O_WRONLY, op_lcd_write },
+	{ "button", "/dev/button_device", O_RDONLY | O_NONBLOCK, op_button_read },
+	{ "led", "/dev/LED_DEVICE", O_WRONLY, op_led_write },
+};
+
+#define NR_NODES (sizeof(nodes) / sizeof(nodes[0]))
+
+static void *client_thread(void *arg) {
+	struct client *c = arg;
+	uint64_t seq = 0;
+	int fd;
+
+	// 클라이언트 하나 = fd 하나 (드라이버는 fd별 상태 없음, 모두 같은 device를 공유)
+	fd = open(c->n->dev, c->n->flags | O_CLOEXEC);
+	if (fd < 0) {
+		report(c, strerror(errno));
+		c->errors++;
+		return NULL;
+	}
+
+	while (!atomic_load_explicit(&stop, memory_order_relaxed)) {
+		if (c->n->op(c, fd, seq++) < 0)
+			c->errors++;
+		c->ops++;
+	}
+
+	close(fd);
+	return NULL;
+}
+
+/*
+ * jmw_i2c_sim의 LCD 1번째 줄: 16칸이 모두 같은 대문자여야 함
+ * @return: 1 정상, 0 위반, -1 sim 없음
+ */
+static int check_sim_lcd(char *line, size_t size) {
+	char buf[512];
+	FILE *fp = fopen(SIM_LCD, "r");
+	char *p;
+	size_t n;
+
+	if (fp == NULL)
+		return -1;
+	n = fread(buf, 1, sizeof(buf) - 1, fp);
+	fclose(fp);
+	buf[n] = '\0';
+
+	// "+----------------+" 다음 줄 "|................|"
+	p = strstr(buf, "+\n|");
+	if (p == NULL || strlen(p) < 3 + LCD_COLS)
+		return 0;
+	p += 3;
+	snprintf(line, size, "%.*s", LCD_COLS, p);
+
+	for (int i = 0; i < LCD_COLS; i++) {
+		if (p[i] != p[0] || p[i] < 'A' || p[i] > 'Z')
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * 모든 node에 클라이언트 nr개씩 동시에 step_s초
+ * @return: 이번 단계의 불변식 위반 + collapse 수
+ */
+static int run_step(int nr, int step_s, double min_ratio) {
+	static struct client clients[NR_NODES][MAX_CLIENTS];
+	uint64_t t0;
+	double elapsed_s;
+	int failures = 0;
+
+	atomic_store(&stop, 0);
+	t0 = now_ns();
+
+	for (size_t i = 0; i < NR_NODES; i++) {
+		if (!nodes[i].enabled)
+			continue;
+
+		for (int j = 0; j < nr; j++) {
+			struct client *c = &clients[i][j];
+			pthread_attr_t attr;
+			cpu_set_t cpus;
+
+			memset(c, 0, sizeof(*c));
+			c->n = &nodes[i];
+			c->id = j;
+
+			// node와 클라이언트를 CPU에 골고루 -> 모든 코어에서 동시에 진입
+			CPU_ZERO(&cpus);
+			CPU_SET((i + j * NR_NODES) % nr_cpus, &cpus);
+			pthread_attr_init(&attr);
+			pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+			if (pthread_create(&c->th, &attr, client_thread, c) != 0) {
+				fprintf(stderr, "pthread create error\n");
+				exit(-1);
+			}
+			pthread_attr_destroy(&attr);
+		}
+	}
+
+	for (int i = 0; i < step_s * 10 && !atomic_load(&interrupted); i++)
+		usleep(100000);
+	atomic_store(&stop, 1);
+
+	// 마지막 sht20 read (~100ms)까지 끝나야 시간이 맞음
+	for (size_t i = 0; i < NR_NODES; i++) {
+		for (int j = 0; nodes[i].enabled && j < nr; j++)
+			pthread_join(clients[i][j].th, NULL);
+	}
+	elapsed_s = (now_ns() - t0) / 1e9;
+
+	for (size_t i = 0; i < NR_NODES; i++) {
+		struct node *n = &nodes[i];
+		uint64_t ops = 0;
+		uint64_t errors = 0;
+		double ops_per_s;
+		double ratio;
+
+		if (!n->enabled)
+			continue;
+
+		for (int j = 0; j < nr; j++) {
+			struct client *c = &clients[i][j];
+
+			ops += c->ops;
+			errors += c->errors;
+			n->zeros += c->zeros;
+			n->ones += c->ones;
+		}
+		ops_per_s = ops / elapsed_s;
+
+		if (nr == 1)
+			n->base_ops_per_s = ops_per_s;
+		ratio = n->base_ops_per_s > 0 ? ops_per_s / n->base_ops_per_s : 0;
+
+		printf("%7d  %-7s %12.1f %12.1f %7.2f %10llu", nr, n->name, ops_per_s, ops_per_s / nr,
+		       ratio, (unsigned long long)errors);
+
+		n->violations += errors;
+		failures += errors > 0;
+
+		if (nr > 1 && n->base_ops_per_s > 0 && ratio < min_ratio) {
+			printf("  COLLAPSE");
+			failures++;
+		}
+
+		if (n->op == op_lcd_write) {
+			char line[LCD_COLS + 1] = "";
+			int ok = check_sim_lcd(line, sizeof(line));
+
+			if (ok >= 0)
+				printf("  lcd \"%s\"%s", line, ok ? "" : " TORN");
+			if (ok == 0) {
+				n->violations++;
+				failures++;
+			}
+		}
+
+		if (n->op == op_button_read) {
+			int64_t diff = (int64_t)n->ones - (int64_t)n->zeros;
+
+			printf("  presses %llu", (unsigned long long)(n->ones + n->zeros));
+			if (diff < -1 || diff > 1) {
+				printf(" DUPLICATE");
+				n->violations++;
+				failures++;
+			}
+		}
+		printf("\n");
+	}
+	fflush(stdout);
+
+	return failures;
+}
+
+static void on_signal(int sig) {
+	(void)sig;
+	atomic_store(&interrupted, 1);
+	atomic_store(&stop, 1);
+}
+
+static void usage(const char *prog) {
+	fprintf(stderr,
+		"usage: %s [-c max_clients] [-d sec] [-m ratio] [node ...]\n"
+		"  node  sht20 | lcd | button | led (default all)\n"
+		"  -c  clients per node, doubled from 1 up to this (default 2 x CPUs, max %d)\n"
+		"  -d  seconds per step (default %d)\n"
+		"  -m  minimum throughput vs. 1 client before it counts as a collapse (default %.1f, 0 = off)\n",
+		prog, MAX_CLIENTS, DEFAULT_STEP_S, DEFAULT_MIN_RATIO);
+}
+
+int main(int argc, char *argv[]) {
+	int max_clients;
+	int step_s = DEFAULT_STEP_S;
+	double min_ratio = DEFAULT_MIN_RATIO;
+	int failures = 0;
+	int enabled = 0;
+	int opt;
+
+	nr_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nr_cpus < 1)
+		nr_cpus = 1;
+	max_clients = nr_cpus * 2;
+
+	while ((opt = getopt(argc, argv, "c:d:m:h")) != -1) {
+		switch (opt) {
+		case 'c':
+			max_clients = atoi(optarg);
+			break;
+		case 'd':
+			step_s = atoi(optarg);
+			break;
+		case 'm':
+			min_ratio = atof(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? 0 : -1;
+		}
+	}
+
+	if (max_clients > MAX_CLIENTS)
+		max_clients = MAX_CLIENTS;
+	if (max_clients < 1 || step_s <= 0 || min_ratio < 0) {
+		usage(argv[0]);
+		return -1;
+	}
+
+	for (size_t i = 0; i < NR_NODES; i++) {
+		int wanted = optind == argc;
+
+		for (int j = optind; j < argc; j++)
+			wanted |= strcmp(argv[j], nodes[i].name) == 0;
+		if (!wanted)
+			continue;
+
+		// 없는 device는 건너뜀 (예: 버튼 없는 VM)
+		if (access(nodes[i].dev, F_OK) < 0) {
+			fprintf(stderr, "%s: %s not found, skipped\n", nodes[i].name, nodes[i].dev);
+			continue;
+		}
+		nodes[i].enabled = 1;
+		enabled++;
+	}
+	if (enabled == 0) {
+		fprintf(stderr, "no device to stress\n");
+		return -1;
+	}
+
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+
+	printf("%d CPUs, up to %d clients per node, %d s per step\n", nr_cpus, max_clients, step_s);
+	printf("%7s  %-7s %12s %12s %7s %10s\n", "clients", "node", "ops/s", "ops/s/client", "scale",
+	       "violations");
+
+	for (int nr = 1; nr <= max_clients; nr *= 2) {
+		failures += run_step(nr, step_s, min_ratio);
+		if (atomic_load(&interrupted))
+			break;
+		if (nr < max_clients && nr * 2 > max_clients)
+			nr = max_clients / 2; // 마지막 단계는 max_clients 그대로
+	}
+
+	for (size_t i = 0; i < NR_NODES; i++) {
+		if (nodes[i].enabled && nodes[i].violations)
+			fprintf(stderr, "%s: %llu violations\n", nodes[i].name,
+				(unsigned long long)nodes[i].violations);
+	}
+
+	return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,79 @@
+#include <string.h>
+
+#include "hist.h"
+
+/*
+ * v < HIST_SUB: 그대로
+ * 그 외: 최상위 비트 아래 HIST_SUB_BITS 비트로 구간 안 위치 결정
+ */
+static int hist_index(uint64_t v) {
+	int msb;
+
+	if (v < HIST_SUB)
+		return v;
+
+	msb = 63 - __builtin_clzll(v);
+	return (msb - HIST_SUB_BITS + 1) * HIST_SUB + (int)((v >> (msb - HIST_SUB_BITS)) - HIST_SUB);
+}
+
+// 구간에 들어가는 가장 큰 값
+static uint64_t hist_value(int idx) {
+	int group = idx / HIST_SUB;
+	uint64_t top = idx % HIST_SUB + HIST_SUB;
+
+	if (idx < HIST_SUB)
+		return idx;
+	return ((top + 1) << (group - 1)) - 1;
+}
+
+void hist_init(struct hist *h) {
+	memset(h, 0, sizeof(*h));
+	h->min = UINT64_MAX;
+}
+
+void hist_record(struct hist *h, uint64_t ns) {
+	h->buckets[hist_index(ns)]++;
+	h->count++;
+	h->sum += ns;
+	if (ns < h->min)
+		h->min = ns;
+	if (ns > h->max)
+		h->max = ns;
+}
+
+void hist_merge(struct hist *dst, const struct hist *src) {
+	for (int i = 0; i < HIST_BUCKETS; i++)
+		dst->buckets[i] += src->buckets[i];
+	dst->count += src->count;
+	dst->sum += src->sum;
+	if (src->min < dst->min)
+		dst->min = src->min;
+	if (src->max > dst->max)
+		dst->max = src->max;
+}
+
+uint64_t hist_percentile(const struct hist *h, double pct) {
+	uint64_t target;
+	uint64_t seen = 0;
+
+	if (h->count == 0)
+		return 0;
+
+	target = (uint64_t)(h->count * pct / 100.0 + 0.5);
+	if (target == 0)
+		target = 1;
+
+	for (int i = 0; i < HIST_BUCKETS; i++) {
+		seen += h->buckets[i];
+		if (seen >= target) {
+			uint64_t v = hist_value(i);
+
+			return v < h->max ? v : h->max;
+		}
+	}
+	return h->max;
+}
+
+uint64_t hist_mean(const struct hist *h) {
+	return h->count ? h->sum / h->count : 0;
+}
@@ -0,0 +1,37 @@
+#ifndef HIST_H
+#define HIST_H
+
+/*
+ * HDR 방식 지연 히스토그램 (ns)
+ *
+ * 2의 거듭제곱 구간마다 HIST_SUB개로 나눔 -> 값 크기와 상관없이 상대 오차 < 1/HIST_SUB
+ * 1ns ~ 2^64ns 전 범위를 고정 크기 배열로, 기록은 O(1) (나눗셈 / 할당 없음)
+ * 스레드마다 하나씩 쓰고 끝나면 hist_merge
+ */
+
+#include <stdint.h>
+
+#define HIST_SUB_BITS 7
+#define HIST_SUB (1 << HIST_SUB_BITS) // 128 -> 오차 < 0.8%
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS + 1) * HIST_SUB)
+
+struct hist {
+	uint64_t count;
+	uint64_t min;
+	uint64_t max;
+	uint64_t sum;
+	uint64_t buckets[HIST_BUCKETS];
+};
+
+void hist_init(struct hist *h);
+void hist_record(struct hist *h, uint64_t ns);
+void hist_merge(struct hist *dst, const struct hist *src);
+
+/*
+ * @pct: 0 ~ 100 (ex: 99.9)
+ * @return: 그 백분위가 들어있는 구간의 최댓값 (보수적), max를 넘지 않음
+ */
+uint64_t hist_percentile(const struct hist *h, double pct);
+uint64_t hist_mean(const struct hist *h);
+
+#endif